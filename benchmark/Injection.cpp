@@ -0,0 +1,263 @@
+/**
+ * Interrupt fault injection driver of the operating system.
+ *
+ * The driver is the user program of an injection image for the FreeRTOS POSIX port.
+ * The image is built as the benchmark image, with EOOS_ENABLE_INTERRUPT_PROFILER
+ * defined, and this file in place of a user program. The driver starts the kernel
+ * scheduler, and injects triggers of interrupt sources at controlled rates from a
+ * thread. Each trigger raises the real-time signal of its source, so the triggers
+ * go through the signal handler and the dispatch of the interrupt resource. A part
+ * of the triggers comes while the source is disabled, so they are kept pending,
+ * and are serviced when the source is enabled.
+ *
+ * Each rate has its own source, and prints one line of space separated key-value
+ * pairs of the source statistics in nanoseconds to the standard output, for example:
+ *
+ * case=inject rate=10000 source=1 injected=10000 triggers=11000 executions=10000 mean_duration=850 max_duration=4200 mean_latency=900 max_latency=5100
+ *
+ * After the rates, the driver prints the longest time all maskable interrupts
+ * have been disabled:
+ *
+ * case=disable_all unit=ns max=2300
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "Program.hpp"
+#include "system.Object.hpp"
+#include "system.Interrupt.hpp"
+#include "system.Clock.hpp"
+#include "api.Task.hpp"
+#include "Error.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stdio.h>
+
+namespace local
+{
+    namespace benchmark
+    {
+        class Injector
+        {
+
+        public:
+
+            /**
+             * Runs all the rates.
+             *
+             * @return zero, or error code if a rate has failed.
+             */
+            static int32 execute()
+            {
+                if( xTaskCreate(&main, "INJECT", STACK_SIZE, NULL, PRIORITY, NULL) != pdPASS ) return ERROR_UNDEFINED;
+                // The call returns when the injector thread stops the scheduler
+                vTaskStartScheduler();
+                return error_;
+            }
+
+        private:
+
+            /**
+             * The time of injecting a rate in nanoseconds.
+             */
+            static const int64 DURATION = 1000000000;
+
+            /**
+             * The time a handler works in nanoseconds.
+             */
+            static const int64 WORK = 500;
+
+            /**
+             * The period of triggers which come while the source is disabled.
+             */
+            static const int32 MASKED = 10;
+
+            /**
+             * The priority of the injector thread.
+             */
+            static const UBaseType_t PRIORITY = tskIDLE_PRIORITY + 2;
+
+            /**
+             * The stack size of the injector thread in words.
+             */
+            static const uint16 STACK_SIZE = configMINIMAL_STACK_SIZE * 4;
+
+            /**
+             * An interrupt handler, which works for a given time.
+             */
+            class Handler : public system::Object, public api::Task
+            {
+                typedef system::Object Parent;
+
+            public:
+
+                /**
+                 * Constructor.
+                 */
+                Handler() : Parent(){
+                }
+
+                /**
+                 * Destructor.
+                 */
+                virtual ~Handler()
+                {
+                }
+
+                /**
+                 * Tests if this object has been constructed.
+                 *
+                 * @return true if object has been constructed successfully.
+                 */
+                virtual bool isConstructed() const
+                {
+                    return Parent::isConstructed();
+                }
+
+                /**
+                 * Works for the given time.
+                 *
+                 * @return zero.
+                 */
+                virtual int32 start()
+                {
+                    int64 const end = system::Clock::getTime() + WORK;
+                    while(system::Clock::getTime() < end)
+                    {
+                    }
+                    return 0;
+                }
+
+                /**
+                 * Returns size of stack.
+                 *
+                 * @return zero, as the handler is executed on the interrupt stack.
+                 */
+                virtual int32 getStackSize() const
+                {
+                    return 0;
+                }
+
+            private:
+
+                /**
+                 * Copy constructor.
+                 *
+                 * @param obj reference to source object.
+                 */
+                Handler(const Handler& obj);
+
+                /**
+                 * Assignment operator.
+                 *
+                 * @param obj reference to source object.
+                 * @return reference to this object.
+                 */
+                Handler& operator =(const Handler& obj);
+
+            };
+
+            /**
+             * Runs all the rates, and stops the scheduler.
+             *
+             * @param argument unused.
+             */
+            static void main(void*)
+            {
+                inject(0, 1000);
+                inject(1, 10000);
+                inject(2, 100000);
+                static_cast<void>( ::printf("case=disable_all unit=ns max=%lld\n",
+                    static_cast<long long>( system::Interrupt::getMaxDisabledTime() )) );
+                static_cast<void>( ::fflush(stdout) );
+                vTaskEndScheduler();
+                vTaskDelete(NULL);
+            }
+
+            /**
+             * Injects triggers of a source at a rate, and prints the source statistics.
+             *
+             * The triggers are injected at even times by waiting for the system clock,
+             * so the rate does not depend on the tick period.
+             *
+             * @param source an interrupt source.
+             * @param rate   the number of triggers per second.
+             */
+            static void inject(int32 const source, int64 const rate)
+            {
+                Handler handler;
+                system::Interrupt interrupt(handler, source);
+                if( not handler.isConstructed() || not interrupt.isConstructed() )
+                {
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                // The source is registered disabled
+                interrupt.enable(true);
+                int64 const period = 1000000000 / rate;
+                int64 next = system::Clock::getTime();
+                int64 const end = next + DURATION;
+                int64 injected = 0;
+                while(next < end)
+                {
+                    while(system::Clock::getTime() < next)
+                    {
+                    }
+                    if(injected % MASKED == MASKED - 1)
+                    {
+                        // The trigger is kept pending, and is serviced by the enabling
+                        bool const is = interrupt.disable();
+                        interrupt.set();
+                        interrupt.enable(is);
+                    }
+                    else
+                    {
+                        interrupt.set();
+                    }
+                    injected++;
+                    next += period;
+                }
+                static_cast<void>( interrupt.disable() );
+                system::Interrupt::Statistics stats;
+                if( not system::Interrupt::getStatistics(source, stats) )
+                {
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                static_cast<void>( ::printf("case=inject rate=%lld source=%d injected=%lld triggers=%lld executions=%lld mean_duration=%lld max_duration=%lld mean_latency=%lld max_latency=%lld\n",
+                    static_cast<long long>(rate),
+                    static_cast<int>(source),
+                    static_cast<long long>(injected),
+                    static_cast<long long>(stats.triggers),
+                    static_cast<long long>(stats.executions),
+                    static_cast<long long>(stats.meanDuration),
+                    static_cast<long long>(stats.maxDuration),
+                    static_cast<long long>(stats.meanLatency),
+                    static_cast<long long>(stats.maxLatency)) );
+                static_cast<void>( ::fflush(stdout) );
+            }
+
+            /**
+             * The error of the driver.
+             */
+            static int32 error_;
+
+        };
+
+        /**
+         * The error of the driver.
+         */
+        int32 Injector::error_ = 0;
+    }
+
+    /**
+     * Starts the fault injection driver.
+     *
+     * @return zero, or error code if a rate has failed.
+     */
+    int32 Program::start()
+    {
+        return benchmark::Injector::execute();
+    }
+}
@@ -0,0 +1,1045 @@
+/**
+ * Microbenchmark suite of the operating system.
+ *
+ * The suite is the user program of a benchmark image for the FreeRTOS POSIX port.
+ * The image is built from the operating system sources with EOOS_PORT_POSIX defined,
+ * and this file in place of a user program. The suite starts the kernel scheduler,
+ * runs all cases in a thread, and stops the scheduler.
+ *
+ * Each case prints one line of space separated key-value pairs of its sample
+ * distribution in nanoseconds to the standard output, so runs are compared by
+ * a diff or a script, for example:
+ *
+ * case=mutex_lock_unlock unit=ns samples=1000 min=21 mean=23 p50=22 p99=35 max=410
+ *
+ * The cases whose names begin with kernel_ measure the kernel paths directly,
+ * and are baselines for the cases of the operating system resources.
+ *
+ * After the cases, the suite prints the stages of the operating system startup
+ * timeline, which are the constructions of its subsystems:
+ *
+ * stage=scheduler unit=ns begin=1520 duration=3400
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "Program.hpp"
+#include "system.System.hpp"
+#include "system.Clock.hpp"
+#include "system.Syscall.hpp"
+#include "system.Timeline.hpp"
+#include "system.Atomic.hpp"
+#include "system.ReadWriteLock.hpp"
+#include "system.Queue.hpp"
+#include "system.MessageBuffer.hpp"
+#include "api.Mutex.hpp"
+#include "api.Semaphore.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace local
+{
+    namespace benchmark
+    {
+        class Suite
+        {
+
+        public:
+
+            /**
+             * Runs all the cases.
+             *
+             * @return zero, or error code if a case has failed.
+             */
+            static int32 execute()
+            {
+                if( xTaskCreate(&main, "BENCH", STACK_SIZE, NULL, PRIORITY, &runner_) != pdPASS ) return ERROR_UNDEFINED;
+                // The call returns when the runner thread stops the scheduler
+                vTaskStartScheduler();
+                return error_;
+            }
+
+        private:
+
+            /**
+             * The number of samples of a case.
+             */
+            static const int32 SAMPLES = 1000;
+
+            /**
+             * The number of operations of a sample of cheap operations.
+             */
+            static const int32 BATCH = 100;
+
+            /**
+             * The priority of the benchmark threads.
+             */
+            static const UBaseType_t PRIORITY = tskIDLE_PRIORITY + 2;
+
+            /**
+             * The stack size of the benchmark threads in words.
+             */
+            static const uint16 STACK_SIZE = configMINIMAL_STACK_SIZE * 4;
+
+            /**
+             * The number of threads competing for a resource.
+             */
+            static const int32 WORKERS = 4;
+
+            /**
+             * The maximum size of a streamed message in bytes.
+             */
+            static const size_t MAX_FRAME = 16384;
+
+            /**
+             * The number of messages which fit the queue of a stream.
+             */
+            static const int32 DEPTH = 4;
+
+            /**
+             * A mix of operations of a reader-writer lock.
+             */
+            struct Mix
+            {
+                /**
+                 * The lock.
+                 */
+                system::ReadWriteLock* lock;
+
+                /**
+                 * The number of writes per hundred operations.
+                 */
+                int32 writes;
+            };
+
+            /**
+             * A stream of messages passed to a receiver thread.
+             */
+            struct Stream
+            {
+                /**
+                 * The zero-copy message buffer, or NULL.
+                 */
+                system::MessageBuffer* buffer;
+
+                /**
+                 * The copying message queue, or NULL.
+                 */
+                system::Queue* queue;
+            };
+
+            /**
+             * A lock of the operating system.
+             */
+            class SystemLock
+            {
+
+            public:
+
+                /**
+                 * Constructor.
+                 */
+                SystemLock() :
+                    mutex_ (system::System::call().createMutex()){
+                }
+
+                /**
+                 * Destructor.
+                 */
+                ~SystemLock()
+                {
+                    delete mutex_;
+                }
+
+                /**
+                 * Tests if the lock has been created.
+                 *
+                 * @return true if the lock has been created.
+                 */
+                bool isCreated() const
+                {
+                    return mutex_ != NULL;
+                }
+
+                /**
+                 * Locks the lock.
+                 */
+                void lock()
+                {
+                    static_cast<void>( mutex_->lock() );
+                }
+
+                /**
+                 * Unlocks the lock.
+                 */
+                void unlock()
+                {
+                    mutex_->unlock();
+                }
+
+            private:
+
+                /**
+                 * The mutex.
+                 */
+                api::Mutex* mutex_;
+
+            };
+
+            /**
+             * A lock of the operating system called by the static dispatch.
+             */
+            class StaticLock
+            {
+
+            public:
+
+                /**
+                 * Constructor.
+                 */
+                StaticLock() :
+                    mutex_ (){
+                }
+
+                /**
+                 * Destructor.
+                 */
+                ~StaticLock()
+                {
+                }
+
+                /**
+                 * Tests if the lock has been created.
+                 *
+                 * @return true if the lock has been created.
+                 */
+                bool isCreated() const
+                {
+                    return mutex_.get() != NULL;
+                }
+
+                /**
+                 * Locks the lock.
+                 */
+                void lock()
+                {
+                    static_cast<void>( system::Syscall::lock(*mutex_.get()) );
+                }
+
+                /**
+                 * Unlocks the lock.
+                 */
+                void unlock()
+                {
+                    system::Syscall::unlock(*mutex_.get());
+                }
+
+            private:
+
+                /**
+                 * The mutex.
+                 */
+                system::Holder<system::Mutex> mutex_;
+
+            };
+
+            /**
+             * A lock of the kernel.
+             */
+            class KernelLock
+            {
+
+            public:
+
+                /**
+                 * Constructor.
+                 */
+                KernelLock() :
+                    mutex_ (xSemaphoreCreateMutex()){
+                }
+
+                /**
+                 * Destructor.
+                 */
+                ~KernelLock()
+                {
+                    if(mutex_ != NULL)
+                    {
+                        vSemaphoreDelete(mutex_);
+                    }
+                }
+
+                /**
+                 * Tests if the lock has been created.
+                 *
+                 * @return true if the lock has been created.
+                 */
+                bool isCreated() const
+                {
+                    return mutex_ != NULL;
+                }
+
+                /**
+                 * Locks the lock.
+                 */
+                void lock()
+                {
+                    static_cast<void>( xSemaphoreTake(mutex_, portMAX_DELAY) );
+                }
+
+                /**
+                 * Unlocks the lock.
+                 */
+                void unlock()
+                {
+                    static_cast<void>( xSemaphoreGive(mutex_) );
+                }
+
+            private:
+
+                /**
+                 * The mutex.
+                 */
+                SemaphoreHandle_t mutex_;
+
+            };
+
+            /**
+             * Runs all the cases, and stops the scheduler.
+             *
+             * @param argument unused.
+             */
+            static void main(void*)
+            {
+                measureClock();
+                measureCurrentThread();
+                measureScheduler();
+                measureContextSwitch();
+                measureLock<SystemLock>("mutex_lock_unlock", "mutex_ping_pong");
+                measureLock<StaticLock>("mutex_static_lock_unlock", "mutex_static_ping_pong");
+                measureLock<KernelLock>("kernel_mutex_take_give", "kernel_mutex_ping_pong");
+                measureSemaphore();
+                measureDispatch();
+                measureFairness(false, "semaphore_unfair_wait");
+                measureFairness(true, "semaphore_fair_wait");
+                measureReadWrite(false, 0, "rwlock_writes_0");
+                measureReadWrite(false, 10, "rwlock_writes_10");
+                measureReadWrite(false, 50, "rwlock_writes_50");
+                measureReadWrite(true, 0, "rwlock_writer_preferred_writes_0");
+                measureReadWrite(true, 10, "rwlock_writer_preferred_writes_10");
+                measureReadWrite(true, 50, "rwlock_writer_preferred_writes_50");
+                measureStream(64);
+                measureStream(1024);
+                measureStream(MAX_FRAME);
+                measureThread();
+                measureHeap(16);
+                measureHeap(256);
+                measureHeap(4096);
+                reportStartup();
+                vTaskEndScheduler();
+                vTaskDelete(NULL);
+            }
+
+            /**
+             * Measures reading the system clock.
+             */
+            static void measureClock()
+            {
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    for(int32 j=0; j<BATCH; j++)
+                    {
+                        static_cast<void>( system::Clock::getTime() );
+                    }
+                    samples_[i] = (system::Clock::getTime() - begin) / BATCH;
+                }
+                report("clock_get_time", SAMPLES);
+            }
+
+            /**
+             * Measures looking up the current kernel task as a baseline.
+             *
+             * The lookup of the operating system thread is not measured, as the
+             * operating system threads are not backed by the kernel tasks yet.
+             */
+            static void measureCurrentThread()
+            {
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    for(int32 j=0; j<BATCH; j++)
+                    {
+                        static_cast<void>( xTaskGetCurrentTaskHandle() );
+                    }
+                    samples_[i] = (system::Clock::getTime() - begin) / BATCH;
+                }
+                report("kernel_current_thread", SAMPLES);
+            }
+
+            /**
+             * Measures looking up the scheduler by the static dispatch and by the virtual call.
+             *
+             * The current thread is not looked up, as the lookup terminates the operating
+             * system until the operating system threads are backed by the kernel tasks.
+             */
+            static void measureScheduler()
+            {
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    for(int32 j=0; j<BATCH; j++)
+                    {
+                        static_cast<void>( &system::Syscall::getScheduler() );
+                    }
+                    samples_[i] = (system::Clock::getTime() - begin) / BATCH;
+                }
+                report("scheduler_syscall", SAMPLES);
+                api::System& sys = system::System::call();
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    for(int32 j=0; j<BATCH; j++)
+                    {
+                        static_cast<void>( &sys.getScheduler() );
+                    }
+                    samples_[i] = (system::Clock::getTime() - begin) / BATCH;
+                }
+                report("scheduler_virtual", SAMPLES);
+            }
+
+            /**
+             * Measures switching between two threads.
+             */
+            static void measureContextSwitch()
+            {
+                TaskHandle_t partner = NULL;
+                if( xTaskCreate(&echo, "ECHO", STACK_SIZE, NULL, PRIORITY, &partner) != pdPASS )
+                {
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    static_cast<void>( xTaskNotifyGive(partner) );
+                    static_cast<void>( ulTaskNotifyTake(pdTRUE, portMAX_DELAY) );
+                    // A round trip has two switches
+                    samples_[i] = (system::Clock::getTime() - begin) / 2;
+                }
+                vTaskDelete(partner);
+                report("context_switch", SAMPLES);
+            }
+
+            /**
+             * Measures a lock uncontended, and handed over between two threads.
+             *
+             * @param uncontended a case name of the uncontended lock.
+             * @param pingPong    a case name of the lock handed over.
+             */
+            template <class L>
+            static void measureLock(const char* const uncontended, const char* const pingPong)
+            {
+                L lock;
+                if( not lock.isCreated() )
+                {
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    for(int32 j=0; j<BATCH; j++)
+                    {
+                        lock.lock();
+                        lock.unlock();
+                    }
+                    samples_[i] = (system::Clock::getTime() - begin) / BATCH;
+                }
+                report(uncontended, SAMPLES);
+                TaskHandle_t partner = NULL;
+                if( xTaskCreate(&contend<L>, "CONTEND", STACK_SIZE, &lock, PRIORITY, &partner) != pdPASS )
+                {
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    lock.lock();
+                    int64 const begin = system::Clock::getTime();
+                    // Let the partner block on the lock
+                    static_cast<void>( xTaskNotifyGive(partner) );
+                    taskYIELD();
+                    lock.unlock();
+                    // The partner takes the lock, releases it, and notifies back
+                    static_cast<void>( ulTaskNotifyTake(pdTRUE, portMAX_DELAY) );
+                    samples_[i] = system::Clock::getTime() - begin;
+                }
+                vTaskDelete(partner);
+                report(pingPong, SAMPLES);
+            }
+
+            /**
+             * Measures passing permits of a semaphore between two threads.
+             */
+            static void measureSemaphore()
+            {
+                api::Semaphore* const sem = system::System::call().createSemaphore(0, false);
+                TaskHandle_t partner = NULL;
+                if( sem == NULL || xTaskCreate(&consume, "CONSUME", STACK_SIZE, sem, PRIORITY, &partner) != pdPASS )
+                {
+                    delete sem;
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    for(int32 j=0; j<BATCH; j++)
+                    {
+                        sem->release();
+                    }
+                    // The partner acquires all the permits, and notifies back
+                    static_cast<void>( ulTaskNotifyTake(pdTRUE, portMAX_DELAY) );
+                    samples_[i] = (system::Clock::getTime() - begin) / BATCH;
+                }
+                vTaskDelete(partner);
+                delete sem;
+                report("semaphore_release_acquire", SAMPLES);
+            }
+
+            /**
+             * Measures calling a semaphore by the virtual and the static dispatch.
+             *
+             * A permit is released and acquired by one thread, so the semaphore
+             * is never contended, and the difference of the cases is the cost of
+             * the virtual calls which are not inlined.
+             */
+            static void measureDispatch()
+            {
+                system::Holder<system::Semaphore> holder(0, false);
+                system::Semaphore* const sem = holder.get();
+                if(sem == NULL)
+                {
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                api::Semaphore& virt = *sem;
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    for(int32 j=0; j<BATCH; j++)
+                    {
+                        virt.release();
+                        static_cast<void>( virt.acquire() );
+                    }
+                    samples_[i] = (system::Clock::getTime() - begin) / BATCH;
+                }
+                report("semaphore_virtual_release_acquire", SAMPLES);
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    for(int32 j=0; j<BATCH; j++)
+                    {
+                        system::Syscall::release(*sem);
+                        static_cast<void>( system::Syscall::acquire(*sem) );
+                    }
+                    samples_[i] = (system::Clock::getTime() - begin) / BATCH;
+                }
+                report("semaphore_static_release_acquire", SAMPLES);
+            }
+
+            /**
+             * Measures waiting for a permit of a semaphore contended by threads.
+             *
+             * The threads have the same priority, and each of them holds the only
+             * permit while it yields to the others, so they queue up for it. The
+             * tail of the distribution shows how long a thread might starve, as an
+             * unfair semaphore lets the releasing thread take the permit again
+             * before a woken thread runs.
+             *
+             * @param isFair true if the semaphore is fair.
+             * @param name   a case name.
+             */
+            static void measureFairness(bool const isFair, const char* const name)
+            {
+                api::Semaphore* const sem = system::System::call().createSemaphore(1, isFair);
+                if(sem == NULL)
+                {
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                bool const isRun = runWorkers(&compete, sem);
+                delete sem;
+                if(isRun)
+                {
+                    report(name, SAMPLES);
+                }
+            }
+
+            /**
+             * Measures operations of a reader-writer lock shared by threads.
+             *
+             * The threads have the same priority, and each of them yields to the
+             * others while it holds the lock, so readers share it, and writers
+             * wait for them. A sample is the mean time of an operation including
+             * the wait for the lock, so the inverse of the mean is the throughput
+             * of a thread at the ratio of writes.
+             *
+             * @param isWriterPreferred true if waiting writers go ahead of new readers.
+             * @param writes            the number of writes per hundred operations.
+             * @param name              a case name.
+             */
+            static void measureReadWrite(bool const isWriterPreferred, int32 const writes, const char* const name)
+            {
+                system::ReadWriteLock lock(isWriterPreferred);
+                if( not lock.isConstructed() )
+                {
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                Mix mix = {&lock, writes};
+                if( runWorkers(&share, &mix) )
+                {
+                    report(name, SAMPLES);
+                }
+            }
+
+            /**
+             * Runs the workers until they have taken the samples.
+             *
+             * @param function a function of the workers, which notifies the runner once it stops.
+             * @param argument an argument of the function.
+             * @return true if all the workers have been run.
+             */
+            static bool runWorkers(TaskFunction_t const function, void* const argument)
+            {
+                index_.store(0);
+                int32 workers = 0;
+                for(; workers<WORKERS; workers++)
+                {
+                    if( xTaskCreate(function, "WORKER", STACK_SIZE, argument, PRIORITY, NULL) != pdPASS )
+                    {
+                        error_ = ERROR_UNDEFINED;
+                        break;
+                    }
+                }
+                // Each worker notifies once it has stopped, and does not use the argument anymore
+                for(int32 i=0; i<workers; i++)
+                {
+                    static_cast<void>( ulTaskNotifyTake(pdFALSE, portMAX_DELAY) );
+                }
+                // Let the idle thread free the terminated threads
+                vTaskDelay(1);
+                return workers == WORKERS;
+            }
+
+            /**
+             * Measures passing messages to a thread by the message buffer and the queue.
+             *
+             * The sender fills each message, which is written in place to the buffer,
+             * or to a frame which the queue copies in, and the receiver reads it in
+             * place of the buffer, or from a frame which the queue copies out, so the
+             * difference of the cases is the cost of the two copies of a message.
+             *
+             * @param size a size of messages.
+             */
+            static void measureStream(size_t const size)
+            {
+                // The frame is static, as it is too large for the thread stack
+                static uint8 frame[MAX_FRAME];
+                // The buffer of the same size fits fewer messages, as they have length words
+                system::MessageBuffer buffer(size * DEPTH);
+                system::Queue queue(DEPTH, size);
+                if( not buffer.isConstructed() || not queue.isConstructed() )
+                {
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                char name[32];
+                Stream stream = {&buffer, NULL};
+                TaskHandle_t partner = NULL;
+                if( xTaskCreate(&drain, "DRAIN", STACK_SIZE, &stream, PRIORITY, &partner) != pdPASS )
+                {
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    for(int32 j=0; j<BATCH; j++)
+                    {
+                        void* const msg = buffer.reserve(size);
+                        ::memset(msg, j, size);
+                        buffer.commit(size);
+                    }
+                    // The partner reads all the messages, and notifies back
+                    static_cast<void>( ulTaskNotifyTake(pdTRUE, portMAX_DELAY) );
+                    samples_[i] = (system::Clock::getTime() - begin) / BATCH;
+                }
+                vTaskDelete(partner);
+                static_cast<void>( ::snprintf(name, sizeof(name), "message_buffer_%u", static_cast<uint32>(size)) );
+                report(name, SAMPLES);
+                stream.buffer = NULL;
+                stream.queue = &queue;
+                if( xTaskCreate(&drain, "DRAIN", STACK_SIZE, &stream, PRIORITY, &partner) != pdPASS )
+                {
+                    error_ = ERROR_UNDEFINED;
+                    return;
+                }
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    for(int32 j=0; j<BATCH; j++)
+                    {
+                        ::memset(frame, j, size);
+                        static_cast<void>( queue.send(frame) );
+                    }
+                    static_cast<void>( ulTaskNotifyTake(pdTRUE, portMAX_DELAY) );
+                    samples_[i] = (system::Clock::getTime() - begin) / BATCH;
+                }
+                vTaskDelete(partner);
+                static_cast<void>( ::snprintf(name, sizeof(name), "queue_%u", static_cast<uint32>(size)) );
+                report(name, SAMPLES);
+            }
+
+            /**
+             * Measures creating a kernel task and waiting for its termination as a baseline.
+             *
+             * The operating system threads are not measured, as they are not
+             * backed by the kernel tasks yet.
+             */
+            static void measureThread()
+            {
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    TaskHandle_t child = NULL;
+                    int64 const begin = system::Clock::getTime();
+                    if( xTaskCreate(&terminate, "CHILD", STACK_SIZE, NULL, PRIORITY, &child) != pdPASS )
+                    {
+                        error_ = ERROR_UNDEFINED;
+                        return;
+                    }
+                    static_cast<void>( ulTaskNotifyTake(pdTRUE, portMAX_DELAY) );
+                    samples_[i] = system::Clock::getTime() - begin;
+                    // Let the idle thread free the terminated thread
+                    vTaskDelay(1);
+                }
+                report("kernel_thread_create_join", SAMPLES);
+            }
+
+            /**
+             * Measures allocating and freeing memory of the heap.
+             *
+             * @param size a size of memory blocks.
+             */
+            static void measureHeap(size_t const size)
+            {
+                api::Heap& heap = system::System::call().getHeap();
+                // The arrays are static, as they are too large for the thread stack
+                static void* blocks[BATCH];
+                static int64 frees[SAMPLES];
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    blocks[i % BATCH] = heap.allocate(size, NULL);
+                    int64 const middle = system::Clock::getTime();
+                    samples_[i] = middle - begin;
+                    // Keep a batch of blocks allocated to have a fragmented heap
+                    if(i % BATCH == BATCH - 1)
+                    {
+                        for(int32 j=0; j<BATCH; j++)
+                        {
+                            int64 const time = system::Clock::getTime();
+                            heap.free(blocks[j]);
+                            frees[i - j] = system::Clock::getTime() - time;
+                        }
+                    }
+                }
+                char name[32];
+                static_cast<void>( ::snprintf(name, sizeof(name), "heap_allocate_%u", static_cast<uint32>(size)) );
+                report(name, SAMPLES);
+                for(int32 i=0; i<SAMPLES; i++)
+                {
+                    samples_[i] = frees[i];
+                }
+                static_cast<void>( ::snprintf(name, sizeof(name), "heap_free_%u", static_cast<uint32>(size)) );
+                report(name, SAMPLES);
+            }
+
+            /**
+             * Notifies back every notification.
+             *
+             * @param argument unused.
+             */
+            static void echo(void*)
+            {
+                while(true)
+                {
+                    static_cast<void>( ulTaskNotifyTake(pdTRUE, portMAX_DELAY) );
+                    static_cast<void>( xTaskNotifyGive(runner_) );
+                }
+            }
+
+            /**
+             * Takes a lock on every notification, and notifies back.
+             *
+             * @param argument the lock.
+             */
+            template <class L>
+            static void contend(void* const argument)
+            {
+                L& lock = *static_cast<L*>(argument);
+                while(true)
+                {
+                    static_cast<void>( ulTaskNotifyTake(pdTRUE, portMAX_DELAY) );
+                    lock.lock();
+                    lock.unlock();
+                    static_cast<void>( xTaskNotifyGive(runner_) );
+                }
+            }
+
+            /**
+             * Acquires a batch of permits, and notifies back.
+             *
+             * @param argument the semaphore.
+             */
+            static void consume(void* const argument)
+            {
+                api::Semaphore& sem = *static_cast<api::Semaphore*>(argument);
+                while(true)
+                {
+                    for(int32 i=0; i<BATCH; i++)
+                    {
+                        static_cast<void>( sem.acquire() );
+                    }
+                    static_cast<void>( xTaskNotifyGive(runner_) );
+                }
+            }
+
+            /**
+             * Acquires a permit until the samples are taken, and notifies back.
+             *
+             * @param argument the semaphore.
+             */
+            static void compete(void* const argument)
+            {
+                api::Semaphore& sem = *static_cast<api::Semaphore*>(argument);
+                while(index_.load() < SAMPLES)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    static_cast<void>( sem.acquire() );
+                    int64 const wait = system::Clock::getTime() - begin;
+                    // Hold the permit while the other workers queue up for it
+                    taskYIELD();
+                    sem.release();
+                    int32 const index = index_.add(1);
+                    if(index < SAMPLES)
+                    {
+                        samples_[index] = wait;
+                    }
+                }
+                static_cast<void>( xTaskNotifyGive(runner_) );
+                vTaskDelete(NULL);
+            }
+
+            /**
+             * Reads and writes under a lock until the samples are taken, and notifies back.
+             *
+             * @param argument the mix of operations.
+             */
+            static void share(void* const argument)
+            {
+                Mix const& mix = *static_cast<Mix*>(argument);
+                int32 operation = 0;
+                while(index_.load() < SAMPLES)
+                {
+                    int64 const begin = system::Clock::getTime();
+                    for(int32 j=0; j<BATCH; j++)
+                    {
+                        // Spread the writes evenly over the operations
+                        if( (operation * mix.writes) % 100 < mix.writes )
+                        {
+                            static_cast<void>( mix.lock->lockWrite() );
+                            taskYIELD();
+                            mix.lock->unlockWrite();
+                        }
+                        else
+                        {
+                            static_cast<void>( mix.lock->lockRead() );
+                            taskYIELD();
+                            mix.lock->unlockRead();
+                        }
+                        operation = (operation + 1) % 100;
+                    }
+                    int64 const time = (system::Clock::getTime() - begin) / BATCH;
+                    int32 const index = index_.add(1);
+                    if(index < SAMPLES)
+                    {
+                        samples_[index] = time;
+                    }
+                }
+                static_cast<void>( xTaskNotifyGive(runner_) );
+                vTaskDelete(NULL);
+            }
+
+            /**
+             * Receives a batch of messages of a stream, and notifies back.
+             *
+             * @param argument the stream.
+             */
+            static void drain(void* const argument)
+            {
+                // The frame is static, as it is too large for the thread stack
+                static uint8 frame[MAX_FRAME];
+                Stream const& stream = *static_cast<Stream*>(argument);
+                while(true)
+                {
+                    for(int32 i=0; i<BATCH; i++)
+                    {
+                        if(stream.buffer != NULL)
+                        {
+                            size_t size = 0;
+                            const void* const msg = stream.buffer->read(size);
+                            checksum_ += *static_cast<const uint8*>(msg);
+                            stream.buffer->release();
+                        }
+                        else
+                        {
+                            static_cast<void>( stream.queue->receive(frame) );
+                            checksum_ += frame[0];
+                        }
+                    }
+                    static_cast<void>( xTaskNotifyGive(runner_) );
+                }
+            }
+
+            /**
+             * Notifies the runner, and terminates.
+             *
+             * @param argument unused.
+             */
+            static void terminate(void*)
+            {
+                static_cast<void>( xTaskNotifyGive(runner_) );
+                vTaskDelete(NULL);
+            }
+
+            /**
+             * Prints the stages of the startup timeline.
+             */
+            static void reportStartup()
+            {
+                system::Timeline::Stage stages[system::Timeline::STAGES];
+                int32 const length = system::Timeline::read(stages, system::Timeline::STAGES);
+                for(int32 i=0; i<length; i++)
+                {
+                    static_cast<void>( ::printf("stage=%s unit=ns begin=%lld duration=%lld\n",
+                        stages[i].name,
+                        static_cast<long long>(stages[i].begin),
+                        static_cast<long long>(stages[i].duration)) );
+                }
+                static_cast<void>( ::fflush(stdout) );
+            }
+
+            /**
+             * Prints the distribution of samples.
+             *
+             * @param name  a case name.
+             * @param count the number of samples.
+             */
+            static void report(const char* const name, int32 const count)
+            {
+                if(count < 1) return;
+                int64 total = 0;
+                // Sort the samples by insertion, as they are few
+                for(int32 i=0; i<count; i++)
+                {
+                    int64 const sample = samples_[i];
+                    int32 j = i;
+                    while(j > 0 && samples_[j - 1] > sample)
+                    {
+                        samples_[j] = samples_[j - 1];
+                        j--;
+                    }
+                    samples_[j] = sample;
+                    total += sample;
+                }
+                static_cast<void>( ::printf("case=%s unit=ns samples=%d min=%lld mean=%lld p50=%lld p99=%lld max=%lld\n",
+                    name,
+                    static_cast<int>(count),
+                    static_cast<long long>(samples_[0]),
+                    static_cast<long long>(total / count),
+                    static_cast<long long>(samples_[count / 2]),
+                    static_cast<long long>(samples_[count * 99 / 100]),
+                    static_cast<long long>(samples_[count - 1])) );
+                static_cast<void>( ::fflush(stdout) );
+            }
+
+            /**
+             * The runner thread.
+             */
+            static TaskHandle_t runner_;
+
+            /**
+             * The samples of a case.
+             */
+            static int64 samples_[SAMPLES];
+
+            /**
+             * The index of the next sample taken by competing threads.
+             */
+            static system::Atomic<int32> index_;
+
+            /**
+             * The sum of read bytes, which keeps the reading of messages.
+             */
+            static uint32 checksum_;
+
+            /**
+             * The error of the suite.
+             */
+            static int32 error_;
+
+        };
+
+        /**
+         * The runner thread.
+         */
+        TaskHandle_t Suite::runner_ = NULL;
+
+        /**
+         * The samples of a case.
+         */
+        int64 Suite::samples_[Suite::SAMPLES];
+
+        /**
+         * The index of the next sample taken by competing threads.
+         */
+        system::Atomic<int32> Suite::index_(0);
+
+        /**
+         * The sum of read bytes, which keeps the reading of messages.
+         */
+        uint32 Suite::checksum_ = 0;
+
+        /**
+         * The error of the suite.
+         */
+        int32 Suite::error_ = 0;
+    }
+
+    /**
+     * Starts the benchmark suite.
+     *
+     * @return zero, or error code if a case has failed.
+     */
+    int32 Program::start()
+    {
+        return benchmark::Suite::execute();
+    }
+}
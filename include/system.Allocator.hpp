@@ -1,5 +1,8 @@
 /** 
  * The operating system memory allocator.
+ *
+ * The allocator takes the memory of the kernel heap, or the static memory
+ * if EOOS_ENABLE_STATIC_MEMORY is defined.
  * 
  * @author    Sergey Baigudin, sergey@baigudin.software
  * @copyright 2016-2018, Embedded Team, Sergey Baigudin
@@ -0,0 +1,156 @@
+/**
+ * Atomic variable.
+ *
+ * The class wraps the compiler atomic built-ins, therefore operations
+ * on a CPU which does not have native atomic instructions for a type
+ * will be executed by the compiler runtime library.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_ATOMIC_HPP_
+#define SYSTEM_ATOMIC_HPP_
+
+#include "Types.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        template <typename T>
+        class Atomic
+        {
+            typedef system::Atomic<T> Self;
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param value an initial value.
+             */
+            explicit Atomic(T value) :
+                value_ (value){
+            }
+
+            /**
+             * Destructor.
+             */
+            ~Atomic()
+            {
+            }
+
+            /**
+             * Returns the value.
+             *
+             * @return the current value.
+             */
+            T load() const
+            {
+                return __atomic_load_n(&value_, __ATOMIC_SEQ_CST);
+            }
+
+            /**
+             * Sets the value.
+             *
+             * @param value a new value.
+             */
+            void store(T value)
+            {
+                __atomic_store_n(&value_, value, __ATOMIC_SEQ_CST);
+            }
+
+            /**
+             * Sets the value and returns the previous one.
+             *
+             * @param value a new value.
+             * @return the previous value.
+             */
+            T exchange(T value)
+            {
+                return __atomic_exchange_n(&value_, value, __ATOMIC_SEQ_CST);
+            }
+
+            /**
+             * Sets the value if the current value equals an expected one.
+             *
+             * @param expected an expected value.
+             * @param value    a new value.
+             * @return true if the value has been set.
+             */
+            bool compareAndSwap(T expected, T value)
+            {
+                return __atomic_compare_exchange_n(&value_, &expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+            }
+
+            /**
+             * Adds to the value and returns the previous one.
+             *
+             * @param value an addend.
+             * @return the previous value.
+             */
+            T add(T value)
+            {
+                return __atomic_fetch_add(&value_, value, __ATOMIC_SEQ_CST);
+            }
+
+            /**
+             * Subtracts from the value and returns the previous one.
+             *
+             * @param value a subtrahend.
+             * @return the previous value.
+             */
+            T subtract(T value)
+            {
+                return __atomic_fetch_sub(&value_, value, __ATOMIC_SEQ_CST);
+            }
+
+            /**
+             * Sets bits of the value and returns the previous one.
+             *
+             * @param mask the bits to set.
+             * @return the previous value.
+             */
+            T setBits(T mask)
+            {
+                return __atomic_fetch_or(&value_, mask, __ATOMIC_SEQ_CST);
+            }
+
+            /**
+             * Clears bits of the value and returns the previous one.
+             *
+             * @param mask the bits to clear.
+             * @return the previous value.
+             */
+            T clearBits(T mask)
+            {
+                return __atomic_fetch_and(&value_, static_cast<T>(~mask), __ATOMIC_SEQ_CST);
+            }
+
+        private:
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            Atomic(const Atomic& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            Atomic& operator =(const Atomic& obj);
+
+            /**
+             * The value.
+             */
+            volatile T value_;
+
+        };
+    }
+}
+#endif // SYSTEM_ATOMIC_HPP_
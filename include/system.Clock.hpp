@@ -0,0 +1,153 @@
+/**
+ * Monotonic system clock.
+ *
+ * The clock counts nanoseconds since its start. The time is taken from the DWT
+ * cycle counter of an ARMv7-M or later core if EOOS_PORT_CORTEX_M is defined, and
+ * from the host monotonic clock if EOOS_PORT_POSIX is defined. The clock of these
+ * ports starts at its first reading, which is done at the beginning of the operating
+ * system construction. Otherwise the clock counts the kernel ticks since the kernel
+ * start, and has the resolution of a tick. The cycle counter runs while the kernel
+ * ticks are pended, as the scheduler is suspended, so the time never goes back.
+ * The clock is read by a few loads without a critical section, so it is safe to
+ * call from threads and interrupt service routines.
+ *
+ * The 32-bit counters are extended to 63 bits, which needs the clock to be read
+ * at least once in a half of the counter period, which is about 12.8 seconds for
+ * 168 MHz cycles. The kernel tick refreshes the clock, as the kernel trace macro
+ * of incrementing the tick calls the clock tick hook, which must be set in
+ * FreeRTOSConfig.h unless EOOS_PORT_POSIX is defined:
+ *
+ * void eoosClockTick(void);
+ *
+ * #define traceTASK_INCREMENT_TICK(xTickCount) eoosClockTick()
+ *
+ * The kernel increments the tick while the scheduler is suspended as well, so
+ * the clock is refreshed on an idle system too. The compilation fails if the hook
+ * is not set, or if EOOS_PORT_CORTEX_M is defined for an ARMv6-M or ARMv8-M
+ * Baseline core, which has no cycle counter.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_CLOCK_HPP_
+#define SYSTEM_CLOCK_HPP_
+
+#include "Types.hpp"
+#include "system.Atomic.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
+
+namespace local
+{
+    namespace system
+    {
+        class Clock
+        {
+            typedef system::Clock Self;
+
+        public:
+
+            /**
+             * Returns the time since the clock start.
+             *
+             * @return time in nanoseconds.
+             */
+            static int64 getTime();
+
+            /**
+             * Refreshes the extension of the counter on a kernel tick.
+             */
+            static void tick();
+
+        private:
+
+            /**
+             * The tick period in nanoseconds.
+             */
+            static const int64 NS_PER_TICK = 1000000000 / configTICK_RATE_HZ;
+
+            /**
+             * Returns the tick count extended to 63 bits.
+             *
+             * @return the number of ticks since the kernel start.
+             */
+            static uint64 getTicks();
+
+            /**
+             * Extends a 32-bit counter to 63 bits.
+             *
+             * @param word the high word of the counter, and the high bit of its last read low word.
+             * @param high the read value of the high word.
+             * @param low  the low word of the counter, which has been read after the high word.
+             * @return the extended counter.
+             */
+            static uint64 extend(Atomic<uint32>& word, uint32 high, uint32 low);
+
+            #if defined(EOOS_PORT_POSIX) || defined(EOOS_PORT_CORTEX_M)
+
+            /**
+             * Returns the time of the counter.
+             *
+             * @return time in nanoseconds.
+             */
+            static int64 getCounterTime();
+
+            #endif
+
+            /**
+             * Constructor.
+             */
+            Clock();
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            Clock(const Clock& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            Clock& operator =(const Clock& obj);
+
+            /**
+             * The high word of the tick count, and the high bit of its last read low word.
+             */
+            static Atomic<uint32> high_;
+
+            #ifdef EOOS_PORT_CORTEX_M
+
+            /**
+             * The high word of the cycle count, and the high bit of its last read low word.
+             */
+            static Atomic<uint32> cycles_;
+
+            #endif // EOOS_PORT_CORTEX_M
+
+            /**
+             * The time of the counter at the clock start.
+             */
+            static int64 base_;
+
+            /**
+             * The clock has been started.
+             */
+            static bool isStarted_;
+
+        };
+    }
+}
+extern "C"
+{
+    /**
+     * Refreshes the clock on a kernel tick.
+     */
+    void eoosClockTick(void);
+}
+
+#endif // SYSTEM_CLOCK_HPP_
@@ -0,0 +1,229 @@
+/**
+ * Condition variable class.
+ *
+ * Threads waiting for the condition sleep in a wait queue of the variable,
+ * so the variable does not create kernel objects. A thread is put to the queue
+ * before it unlocks the mutex, therefore a notification sent after the unlocking
+ * is never lost. Notifying all the threads releases the whole queue in one
+ * critical section.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_CONDITION_VARIABLE_HPP_
+#define SYSTEM_CONDITION_VARIABLE_HPP_
+
+#include "system.Object.hpp"
+#include "api.Resource.hpp"
+#include "api.Mutex.hpp"
+#include "system.Interrupt.hpp"
+#include "system.Atomic.hpp"
+#include "system.WaitQueue.hpp"
+#include "system.Timeout.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class ConditionVariable : public system::Object, public api::Resource
+        {
+            typedef system::ConditionVariable Self;
+            typedef system::Object            Parent;
+
+        public:
+
+            /**
+             * Constructor.
+             */
+            ConditionVariable() : Parent(),
+                waiters_ (0),
+                queue_   (true){
+                bool const isConstructed = construct();
+                setConstructed( isConstructed );
+            }
+
+            /**
+             * Destructor.
+             */
+            virtual ~ConditionVariable()
+            {
+            }
+
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            virtual bool isConstructed() const
+            {
+                return Parent::isConstructed();
+            }
+
+            /**
+             * Unlocks a mutex, sleeps until a notification, and locks the mutex again.
+             *
+             * @param mutex a mutex locked by the caller thread.
+             * @return true if the thread has been notified and the mutex has been locked.
+             */
+            bool wait(api::Mutex& mutex)
+            {
+                if( not Self::isConstructed() ) return false;
+                WaitQueue::Waiter waiter(1);
+                enter(waiter);
+                mutex.unlock();
+                WaitQueue::wait(waiter);
+                return mutex.lock();
+            }
+
+            /**
+             * Unlocks a mutex, sleeps until a notification or a timeout, and locks the mutex again.
+             *
+             * @param mutex  a mutex locked by the caller thread.
+             * @param millis a time to wait in milliseconds.
+             * @return true if the thread has been notified, or false if the timeout has expired.
+             */
+            bool wait(api::Mutex& mutex, int64 millis)
+            {
+                if( not Self::isConstructed() ) return false;
+                Timeout timeout(millis);
+                WaitQueue::Waiter waiter(1);
+                enter(waiter);
+                mutex.unlock();
+                bool const isNotified = WaitQueue::wait(waiter, timeout) || leave(waiter);
+                bool const isLocked = mutex.lock();
+                return isNotified && isLocked;
+            }
+
+            /**
+             * Wakes up the first waiting thread.
+             */
+            void notify()
+            {
+                if( not Self::isConstructed() ) return;
+                if( waiters_.load() == 0 ) return;
+                BaseType_t isWoken = pdFALSE;
+                BaseType_t* const woken = Interrupt::isInterrupt() ? &isWoken : NULL;
+                bool const is = Interrupt::disableAll();
+                if( not queue_.isEmpty() )
+                {
+                    static_cast<void>( waiters_.subtract(1) );
+                    queue_.signalFirst(woken);
+                }
+                Interrupt::enableAll(is);
+                if(woken != NULL)
+                {
+                    portYIELD_FROM_ISR(isWoken);
+                }
+            }
+
+            /**
+             * Wakes up all the waiting threads.
+             *
+             * Each thread is woken up by its own kernel call with disabled interrupts,
+             * so the time the interrupts are disabled grows with the number of waiting
+             * threads. If many threads wait, notify only the threads which can proceed.
+             */
+            void notifyAll()
+            {
+                if( not Self::isConstructed() ) return;
+                if( waiters_.load() == 0 ) return;
+                BaseType_t isWoken = pdFALSE;
+                BaseType_t* const woken = Interrupt::isInterrupt() ? &isWoken : NULL;
+                bool const is = Interrupt::disableAll();
+                while( not queue_.isEmpty() )
+                {
+                    static_cast<void>( waiters_.subtract(1) );
+                    queue_.signalFirst(woken);
+                }
+                Interrupt::enableAll(is);
+                if(woken != NULL)
+                {
+                    portYIELD_FROM_ISR(isWoken);
+                }
+            }
+
+            /**
+             * Tests if this resource is blocked.
+             *
+             * @return true if some threads wait for a notification.
+             */
+            virtual bool isBlocked() const
+            {
+                if( not Self::isConstructed() ) return false;
+                return waiters_.load() != 0;
+            }
+
+        private:
+
+            /**
+             * Constructor.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            bool construct()
+            {
+                if( not Self::isConstructed() ) return false;
+                return true;
+            }
+
+            /**
+             * Puts a thread to the wait queue.
+             *
+             * @param waiter the thread record.
+             */
+            void enter(WaitQueue::Waiter& waiter)
+            {
+                bool const is = Interrupt::disableAll();
+                static_cast<void>( waiters_.add(1) );
+                queue_.add(waiter);
+                Interrupt::enableAll(is);
+            }
+
+            /**
+             * Removes a timed out thread from the wait queue.
+             *
+             * @param waiter the thread record.
+             * @return true if the thread has been notified before the removal.
+             */
+            bool leave(WaitQueue::Waiter& waiter)
+            {
+                bool const is = Interrupt::disableAll();
+                bool const isNotified = not queue_.remove(waiter);
+                if( not isNotified )
+                {
+                    static_cast<void>( waiters_.subtract(1) );
+                }
+                Interrupt::enableAll(is);
+                return isNotified;
+            }
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            ConditionVariable(const ConditionVariable& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            ConditionVariable& operator =(const ConditionVariable& obj);
+
+            /**
+             * The number of threads in the wait queue.
+             */
+            Atomic<int32> waiters_;
+
+            /**
+             * The threads waiting for a notification.
+             */
+            WaitQueue queue_;
+
+        };
+    }
+}
+#endif // SYSTEM_CONDITION_VARIABLE_HPP_
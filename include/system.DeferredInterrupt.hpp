@@ -0,0 +1,274 @@
+/**
+ * Deferred interrupt resource.
+ *
+ * The resource splits an interrupt handler into two parts. The interrupt service
+ * routine only clears the interrupt status of the source, disables the source,
+ * and signals a daemon thread, and the daemon thread then executes the user
+ * handler with interrupts enabled, and enables the source again unless a user
+ * has disabled it. Each resource has a bit of the daemon notification value, so
+ * triggers of one source, which come before the handler is executed, are coalesced
+ * into one execution. The daemon thread clears the bit together with looking up
+ * its resource, and a destroyed resource clears its bit, so a resource, which
+ * takes the bit over, is never executed for a trigger of the former one. A handler
+ * might delete its own resource, and the daemon thread then does not use the
+ * resource after the handler returns. All the resources share one daemon thread
+ * of the highest priority, and up to 32 resources are available.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_DEFERRED_INTERRUPT_HPP_
+#define SYSTEM_DEFERRED_INTERRUPT_HPP_
+
+#include "system.Object.hpp"
+#include "api.Interrupt.hpp"
+#include "api.Task.hpp"
+#include "system.Interrupt.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
+
+namespace local
+{
+    namespace system
+    {
+        class DeferredInterrupt : public system::Object, public api::Interrupt
+        {
+            typedef system::DeferredInterrupt Self;
+            typedef system::Object            Parent;
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param handler user class which implements an interrupt handler interface.
+             * @param source  available interrupt source.
+             */
+            DeferredInterrupt(api::Task& handler, int32 source);
+
+            /**
+             * Destructor.
+             */
+            virtual ~DeferredInterrupt();
+
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            virtual bool isConstructed() const;
+
+            /**
+             * Jumps to interrupt hardware vector.
+             */
+            virtual void jump();
+
+            /**
+             * Clears an interrupt status of this source.
+             */
+            virtual void clear();
+
+            /**
+             * Sets an interrupt status of this source.
+             */
+            virtual void set();
+
+            /**
+             * Locks this interrupt source.
+             *
+             * @return an interrupt enable source bit value before method was called.
+             */
+            virtual bool disable();
+
+            /**
+             * Unlocks this interrupt source.
+             *
+             * @param status returned status by lock method.
+             */
+            virtual void enable(bool status);
+
+            /**
+             * Requests the handler execution from a thread.
+             */
+            void raise();
+
+            /**
+             * Requests the handler execution from an interrupt service routine.
+             */
+            void raiseFromInterrupt();
+
+        private:
+
+            /**
+             * The maximum number of resources.
+             */
+            static const int32 SLOTS = 32;
+
+            /**
+             * The stack size of the daemon thread in words.
+             */
+            static const uint16 STACK_SIZE = configMINIMAL_STACK_SIZE * 4;
+
+            /**
+             * The interrupt service routine part of the handler.
+             */
+            class Acknowledger : public system::Object, public api::Task
+            {
+                typedef system::Object Parent;
+
+            public:
+
+                /**
+                 * Constructor.
+                 *
+                 * @param owner the resource of the handler.
+                 */
+                explicit Acknowledger(DeferredInterrupt& owner) : Parent(),
+                    owner_ (owner){
+                }
+
+                /**
+                 * Destructor.
+                 */
+                virtual ~Acknowledger()
+                {
+                }
+
+                /**
+                 * Tests if this object has been constructed.
+                 *
+                 * @return true if object has been constructed successfully.
+                 */
+                virtual bool isConstructed() const
+                {
+                    return Parent::isConstructed();
+                }
+
+                /**
+                 * Clears the interrupt status, disables the source, and signals the daemon thread.
+                 *
+                 * @return zero.
+                 */
+                virtual int32 start()
+                {
+                    owner_.interrupt_.clear();
+                    // The source is disabled until the daemon thread has executed the handler
+                    owner_.isMasked_ = true;
+                    static_cast<void>( owner_.interrupt_.disable() );
+                    owner_.raiseFromInterrupt();
+                    return 0;
+                }
+
+                /**
+                 * Returns size of stack.
+                 *
+                 * @return zero, as the routine is executed on the interrupt stack.
+                 */
+                virtual int32 getStackSize() const
+                {
+                    return 0;
+                }
+
+            private:
+
+                /**
+                 * Copy constructor.
+                 *
+                 * @param obj reference to source object.
+                 */
+                Acknowledger(const Acknowledger& obj);
+
+                /**
+                 * Assignment operator.
+                 *
+                 * @param obj reference to source object.
+                 * @return reference to this object.
+                 */
+                Acknowledger& operator =(const Acknowledger& obj);
+
+                /**
+                 * The resource of the handler.
+                 */
+                DeferredInterrupt& owner_;
+
+            };
+
+            /**
+             * Constructor.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            bool construct();
+
+            /**
+             * Executes handlers of signaled resources.
+             *
+             * @param argument unused.
+             */
+            static void main(void* argument);
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            DeferredInterrupt(const DeferredInterrupt& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            DeferredInterrupt& operator =(const DeferredInterrupt& obj);
+
+            /**
+             * The user handler.
+             */
+            api::Task& handler_;
+
+            /**
+             * The interrupt service routine part of the handler.
+             */
+            Acknowledger acknowledger_;
+
+            /**
+             * The interrupt resource of the source.
+             */
+            system::Interrupt interrupt_;
+
+            /**
+             * The bit of this resource in the daemon notification value.
+             */
+            uint32 bit_;
+
+            /**
+             * The source is enabled by a user.
+             */
+            bool volatile isEnabled_;
+
+            /**
+             * The source is disabled by the interrupt service routine until the handler is executed.
+             */
+            bool volatile isMasked_;
+
+            /**
+             * The daemon thread.
+             */
+            static TaskHandle_t daemon_;
+
+            /**
+             * The resources indexed by their bits.
+             */
+            static DeferredInterrupt* slots_[SLOTS];
+
+            /**
+             * The resource which handler is being executed.
+             */
+            static DeferredInterrupt* volatile current_;
+
+        };
+    }
+}
+#endif // SYSTEM_DEFERRED_INTERRUPT_HPP_
@@ -0,0 +1,258 @@
+/**
+ * Event flags class.
+ *
+ * The event flags are a kernel event group. Any number of threads wait for
+ * any or all of given flags, and setting flags wakes all the threads whose
+ * conditions are met by one kernel call. The kernel reserves upper bits of
+ * its event bits type, so only lower 24 flags are available, or only lower
+ * 8 flags if the kernel is configured with 16-bit ticks. The methods reject
+ * no flags or flags out of the available ones, as the kernel would take
+ * them for its control bits.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_EVENT_GROUP_HPP_
+#define SYSTEM_EVENT_GROUP_HPP_
+
+#include "system.Object.hpp"
+#include "api.Resource.hpp"
+#include "system.Timeout.hpp"
+#include "FreeRTOS.h"
+#include "event_groups.h"
+
+namespace local
+{
+    namespace system
+    {
+        class EventGroup : public system::Object, public api::Resource
+        {
+            typedef system::EventGroup Self;
+            typedef system::Object     Parent;
+
+        public:
+
+            /**
+             * Constructor.
+             */
+            EventGroup() : Parent(),
+                group_ (NULL){
+                bool const isConstructed = construct();
+                setConstructed( isConstructed );
+            }
+
+            /**
+             * Destructor.
+             */
+            virtual ~EventGroup()
+            {
+                if(group_ != NULL)
+                {
+                    vEventGroupDelete(group_);
+                }
+            }
+
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            virtual bool isConstructed() const
+            {
+                return Parent::isConstructed();
+            }
+
+            /**
+             * Sets flags, and wakes up all the threads which wait for them.
+             *
+             * @param flags the flags to set.
+             * @return the flags after setting, or zero if the flags are not valid.
+             */
+            uint32 set(uint32 flags)
+            {
+                if( not Self::isConstructed() ) return 0;
+                if( not isValid(flags) ) return 0;
+                return static_cast<uint32>( xEventGroupSetBits(group_, static_cast<EventBits_t>(flags)) );
+            }
+
+            /**
+             * Sets flags from an interrupt service routine.
+             *
+             * The kernel defers the setting to its timer daemon thread.
+             *
+             * @param flags the flags to set.
+             * @return true if the setting has been passed to the daemon.
+             */
+            bool setFromInterrupt(uint32 flags)
+            {
+                if( not Self::isConstructed() ) return false;
+                if( not isValid(flags) ) return false;
+                BaseType_t isWoken = pdFALSE;
+                bool const res = xEventGroupSetBitsFromISR(group_, static_cast<EventBits_t>(flags), &isWoken) == pdPASS;
+                portYIELD_FROM_ISR(isWoken);
+                return res;
+            }
+
+            /**
+             * Clears flags.
+             *
+             * @param flags the flags to clear.
+             * @return the flags before clearing, or zero if the flags are not valid.
+             */
+            uint32 clear(uint32 flags)
+            {
+                if( not Self::isConstructed() ) return 0;
+                if( not isValid(flags) ) return 0;
+                return static_cast<uint32>( xEventGroupClearBits(group_, static_cast<EventBits_t>(flags)) );
+            }
+
+            /**
+             * Returns the flags.
+             *
+             * @return the current flags.
+             */
+            uint32 get() const
+            {
+                if( not Self::isConstructed() ) return 0;
+                return static_cast<uint32>( xEventGroupGetBits(group_) );
+            }
+
+            /**
+             * Sleeps until any of given flags is set.
+             *
+             * @param flags     the flags to wait for.
+             * @param isCleared true if the awaited flags are cleared on return.
+             * @return the flags when the condition has been met.
+             */
+            uint32 waitAny(uint32 flags, bool isCleared)
+            {
+                return wait(flags, isCleared, false, portMAX_DELAY);
+            }
+
+            /**
+             * Sleeps until any of given flags is set, or a timeout expires.
+             *
+             * @param flags     the flags to wait for.
+             * @param isCleared true if the awaited flags are cleared on return.
+             * @param millis    a time to wait in milliseconds.
+             * @return the flags when the condition has been met, or when the timeout has expired.
+             */
+            uint32 waitAny(uint32 flags, bool isCleared, int64 millis)
+            {
+                return wait(flags, isCleared, false, Timeout::toTicks(millis));
+            }
+
+            /**
+             * Sleeps until all of given flags are set.
+             *
+             * @param flags     the flags to wait for.
+             * @param isCleared true if the awaited flags are cleared on return.
+             * @return the flags when the condition has been met.
+             */
+            uint32 waitAll(uint32 flags, bool isCleared)
+            {
+                return wait(flags, isCleared, true, portMAX_DELAY);
+            }
+
+            /**
+             * Sleeps until all of given flags are set, or a timeout expires.
+             *
+             * @param flags     the flags to wait for.
+             * @param isCleared true if the awaited flags are cleared on return.
+             * @param millis    a time to wait in milliseconds.
+             * @return the flags when the condition has been met, or when the timeout has expired.
+             */
+            uint32 waitAll(uint32 flags, bool isCleared, int64 millis)
+            {
+                return wait(flags, isCleared, true, Timeout::toTicks(millis));
+            }
+
+            /**
+             * Tests if this resource is blocked.
+             *
+             * @return true if no flags are set.
+             */
+            virtual bool isBlocked() const
+            {
+                if( not Self::isConstructed() ) return false;
+                return get() == 0;
+            }
+
+        private:
+
+            /**
+             * The available flags.
+             */
+            #if ( defined(configUSE_16_BIT_TICKS) && configUSE_16_BIT_TICKS == 1 ) || ( defined(configTICK_TYPE_WIDTH_IN_BITS) && configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS )
+            static const uint32 FLAGS = 0x000000FF;
+            #else
+            static const uint32 FLAGS = 0x00FFFFFF;
+            #endif
+
+            /**
+             * Constructor.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            bool construct()
+            {
+                if( not Self::isConstructed() ) return false;
+                group_ = xEventGroupCreate();
+                if(group_ == NULL) return false;
+                return true;
+            }
+
+            /**
+             * Sleeps until given flags are set.
+             *
+             * @param flags     the flags to wait for.
+             * @param isCleared true if the awaited flags are cleared on return.
+             * @param isAll     true to wait for all the flags, or false to wait for any of them.
+             * @param ticks     the kernel ticks to wait.
+             * @return the flags when the condition has been met, or when the ticks have expired, or zero if the flags are not valid.
+             */
+            uint32 wait(uint32 flags, bool isCleared, bool isAll, TickType_t ticks)
+            {
+                if( not Self::isConstructed() ) return 0;
+                if( not isValid(flags) ) return 0;
+                BaseType_t const clear = isCleared ? pdTRUE : pdFALSE;
+                BaseType_t const all = isAll ? pdTRUE : pdFALSE;
+                return static_cast<uint32>( xEventGroupWaitBits(group_, static_cast<EventBits_t>(flags), clear, all, ticks) );
+            }
+
+            /**
+             * Tests if flags are some of the available flags.
+             *
+             * @param flags the flags.
+             * @return true if the flags are valid.
+             */
+            static bool isValid(uint32 flags)
+            {
+                return flags != 0 && (flags & ~FLAGS) == 0;
+            }
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            EventGroup(const EventGroup& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            EventGroup& operator =(const EventGroup& obj);
+
+            /**
+             * The kernel event group.
+             */
+            EventGroupHandle_t group_;
+
+        };
+    }
+}
+#endif // SYSTEM_EVENT_GROUP_HPP_
@@ -1,14 +1,24 @@
-/** 
+/**
  * Hardware global interrupts resource.
- * 
+ *
+ * The resource disables all maskable interrupts by the nesting-aware critical
+ * section of the interrupt class, so each disabling is left by the enabling
+ * with its status, and the interrupts are enabled when the outermost one is left.
+ *
+ * If EOOS_ENABLE_INTERRUPT_PROFILER is defined, the interrupt class keys the
+ * outermost regions of each core by the call site of disabling, and the resource
+ * passes the return address of its disable method, so a region is attributed to
+ * the caller of the resource.
+ *
  * @author    Sergey Baigudin, sergey@baigudin.software
  * @copyright 2014-2018, Embedded Team, Sergey Baigudin
  * @license   http://embedded.team/license/
  */
 #ifndef SYSTEM_GLOBAL_INTERRUPT_HPP_
 #define SYSTEM_GLOBAL_INTERRUPT_HPP_
-    
+
 #include "system.Object.hpp"
+#include "system.Interrupt.hpp"
 #include "api.Toggle.hpp"
 
 namespace local
@@ -19,70 +29,78 @@ namespace local
         {
             typedef system::GlobalInterrupt Self;
             typedef system::Object          Parent;
-        
+
         public:
-          
-            /** 
+
+            /**
+             * Statistics of a call site.
+             */
+            typedef Interrupt::Site Site;
+
+            /**
              * Constructor.
              */
-            GlobalInterrupt() : Parent()
-            {
-            }  
-            
-            /** 
+            GlobalInterrupt();
+
+            /**
              * Destructor.
-             */                               
-            virtual ~GlobalInterrupt()
-            {
-            }
-            
+             */
+            virtual ~GlobalInterrupt();
+
             /**
              * Tests if this object has been constructed.
              *
              * @return true if object has been constructed successfully.
-             */    
-            virtual bool isConstructed() const
-            {
-                return Parent::isConstructed();
-            }
-            
-            /** 
+             */
+            virtual bool isConstructed() const;
+
+            /**
              * Disables all maskable interrupts.
              *
              * @return global interrupt enable bit value before method was called.
-             */ 
-            virtual bool disable()
-            {
-                return false;
-            }        
-            
-            /** 
+             */
+            virtual bool disable();
+
+            /**
              * Enables all maskable interrupts.
              *
              * @param status returned status by disable method.
-             */    
-            virtual void enable(bool status)
-            {
-            }        
-          
+             */
+            virtual void enable(bool status);
+
+            /**
+             * Copies statistics of call sites.
+             *
+             * @param sites a buffer for statistics.
+             * @param count the maximum number of sites to copy.
+             * @return the number of sites copied.
+             */
+            static int32 getSites(Site* sites, int32 count);
+
+            /**
+             * Returns the number of regions of call sites which have not fit the table.
+             *
+             * @return the number of regions.
+             */
+            static int64 getLost();
+
         private:
-        
+
             /**
              * Copy constructor.
              *
              * @param obj reference to source object.
              */
             GlobalInterrupt(const GlobalInterrupt& obj);
-          
+
             /**
              * Assignment operator.
              *
              * @param obj reference to source object.
-             * @return reference to this object.     
+             * @return reference to this object.
              */
-            GlobalInterrupt& operator =(const GlobalInterrupt& obj);    
-
-        }; 
+            GlobalInterrupt& operator =(const GlobalInterrupt& obj);
+        };
     }
 }
 #endif // SYSTEM_GLOBAL_INTERRUPT_HPP_
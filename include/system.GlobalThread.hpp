@@ -1,5 +1,13 @@
 /** 
  * Global thread switching controller.
+ *
+ * The controller suspends the kernel scheduler, so a region between disabling
+ * and enabling is not preempted by other threads, while interrupts are still
+ * serviced. Nested regions suspend the scheduler once, as only the outermost
+ * disabling returns the enabled status, and only enabling with this status
+ * resumes the scheduler. The controller does nothing if the scheduler does not
+ * run or if it is called from an interrupt service routine, which no thread
+ * preempts. A disabled region must not block.
  * 
  * @author    Sergey Baigudin, sergey@baigudin.software
  * @copyright 2017-2018, Embedded Team, Sergey Baigudin
@@ -10,6 +18,9 @@
     
 #include "system.Object.hpp"
 #include "api.Toggle.hpp"
+#include "system.Interrupt.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
 
 namespace local
 {
@@ -47,22 +58,30 @@ namespace local
             }
             
             /** 
-             * Disables all maskable interrupts.
+             * Disables thread switching.
              *
-             * @return global interrupt enable bit value before method was called.
+             * @return true if thread switching has been enabled before the method was called.
              */ 
             virtual bool disable()
             {
-                return false;
+                if( not Self::isUsable() ) return false;
+                if( Interrupt::isInterrupt() ) return false;
+                if( xTaskGetSchedulerState() != taskSCHEDULER_RUNNING ) return false;
+                vTaskSuspendAll();
+                return true;
             }        
             
             /** 
-             * Enables all maskable interrupts.
+             * Enables thread switching.
              *
              * @param status returned status by disable method.
              */    
-            virtual void enable(bool status)
+            virtual void enable(bool const status)
             {
+                if( not Self::isUsable() ) return;
+                if( not status ) return;
+                // A thread switch pended while the scheduler has been suspended is done here
+                static_cast<void>( xTaskResumeAll() );
             }        
           
         private:
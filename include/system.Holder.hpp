@@ -0,0 +1,147 @@
+/**
+ * Holder of a resource constructed in place.
+ *
+ * The holder constructs a resource in its own memory, so a resource is held
+ * statically or on a stack, and gives the resource only if it has been
+ * constructed successfully. A resource which has failed is destroyed at once.
+ * If EOOS_DISABLE_CONSTRUCTION_CHECKS is defined, the resources, which methods
+ * do not test their construction then, have no public constructors, so they are
+ * created by the factories of the operating system, or held by holders.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_HOLDER_HPP_
+#define SYSTEM_HOLDER_HPP_
+
+#include "Types.hpp"
+#include <new>
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * @param T a resource type.
+         */
+        template <class T>
+        class Holder
+        {
+            typedef system::Holder<T> Self;
+
+        public:
+
+            /**
+             * Constructor.
+             */
+            Holder() :
+                obj_ (NULL){
+                hold( ::new (storage_) T() );
+            }
+
+            /**
+             * Constructor.
+             *
+             * @param a1 the first argument of the resource constructor.
+             */
+            template <typename A1>
+            explicit Holder(A1 a1) :
+                obj_ (NULL){
+                hold( ::new (storage_) T(a1) );
+            }
+
+            /**
+             * Constructor.
+             *
+             * @param a1 the first argument of the resource constructor.
+             * @param a2 the second argument of the resource constructor.
+             */
+            template <typename A1, typename A2>
+            Holder(A1 a1, A2 a2) :
+                obj_ (NULL){
+                hold( ::new (storage_) T(a1, a2) );
+            }
+
+            /**
+             * Constructor.
+             *
+             * @param a1 the first argument of the resource constructor.
+             * @param a2 the second argument of the resource constructor.
+             * @param a3 the third argument of the resource constructor.
+             */
+            template <typename A1, typename A2, typename A3>
+            Holder(A1 a1, A2 a2, A3 a3) :
+                obj_ (NULL){
+                hold( ::new (storage_) T(a1, a2, a3) );
+            }
+
+            /**
+             * Destructor.
+             */
+            ~Holder()
+            {
+                if(obj_ != NULL)
+                {
+                    obj_->~T();
+                }
+            }
+
+            /**
+             * Returns the resource.
+             *
+             * @return the resource, or NULL if it has not been constructed successfully.
+             */
+            T* get() const
+            {
+                return obj_;
+            }
+
+        private:
+
+            /**
+             * Holds a resource if it has been constructed successfully.
+             *
+             * @param obj the resource.
+             */
+            void hold(T* const obj)
+            {
+                if( obj->isConstructed() )
+                {
+                    obj_ = obj;
+                }
+                else
+                {
+                    obj->~T();
+                }
+            }
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            Holder(const Holder& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            Holder& operator =(const Holder& obj);
+
+            /**
+             * The resource, or NULL if it has not been constructed successfully.
+             */
+            T* obj_;
+
+            /**
+             * The memory of the resource.
+             */
+            uint64 storage_[(sizeof(T) + sizeof(uint64) - 1) / sizeof(uint64)];
+
+        };
+    }
+}
+#endif // SYSTEM_HOLDER_HPP_
@@ -1,6 +1,27 @@
 /** 
  * Hardware interrupt resource.
  * 
+ * Each source has an entry of the interrupt source table, which keeps its handler,
+ * and bits of software enable and pending masks. An interrupt vector of a source
+ * calls the dispatch method directly, or through a trampoline returned by getVector.
+ * A trigger of a disabled source is kept pending, and is serviced when the source
+ * is enabled. If EOOS_PORT_POSIX is defined, the sources are real-time POSIX signals
+ * starting from SIGRTMIN. If EOOS_PORT_CORTEX_M is defined, the sources are the NVIC
+ * external interrupts 0 to 31, which are enabled, disabled, and set in hardware, so
+ * the hardware delivers them to the vectors, which are the trampolines of the sources
+ * placed to the vector table of the device. Otherwise a source set by software is
+ * serviced in place.
+ *
+ * Disabling all maskable interrupts in a thread enters a kernel critical section,
+ * and the kernel counts the nesting of the sections of each core. In an interrupt
+ * service routine, only the outermost disabling on a core masks the interrupts,
+ * and keeps the previous mask of the core for the enabling.
+ *
+ * If EOOS_ENABLE_INTERRUPT_PROFILER is defined, the outermost disabling of a core
+ * is timed and keyed by its call site, which is the return address of the disabling
+ * method, or the address passed by a wrapper on behalf of its caller. A site is
+ * looked up in the site table after the interrupts are enabled again.
+ *
  * @author    Sergey Baigudin, sergey@baigudin.software
  * @copyright 2014-2018, Embedded Team, Sergey Baigudin
  * @license   http://embedded.team/license/
@@ -11,6 +32,9 @@
 #include "system.Object.hpp"
 #include "api.Interrupt.hpp"
 #include "api.Task.hpp"
+#include "system.Atomic.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
 
 namespace local
 {
@@ -22,6 +46,94 @@ namespace local
             typedef system::Object    Parent;
         
         public:
+
+            /**
+             * The number of interrupt sources.
+             */
+            static const int32 SOURCES = 32;
+
+            /**
+             * The number of cores.
+             */
+            #if defined(configNUMBER_OF_CORES) && configNUMBER_OF_CORES > 1
+            static const int32 CORES = configNUMBER_OF_CORES;
+            #else
+            static const int32 CORES = 1;
+            #endif
+
+            /**
+             * An interrupt vector.
+             */
+            typedef void (*Vector)();
+
+
+            /**
+             * Statistics of an interrupt source.
+             *
+             * The statistics are collected only if EOOS_ENABLE_INTERRUPT_PROFILER is defined.
+             */
+            struct Statistics
+            {
+                /**
+                 * The number of triggers of the source.
+                 */
+                int64 triggers;
+
+                /**
+                 * The number of handler executions.
+                 */
+                int64 executions;
+
+                /**
+                 * The maximum handler duration in nanoseconds.
+                 */
+                int64 maxDuration;
+
+                /**
+                 * The mean handler duration in nanoseconds.
+                 */
+                int64 meanDuration;
+
+                /**
+                 * The maximum time from setting the source to entering its handler in nanoseconds.
+                 *
+                 * The latency is measured only for sources set by software, as only they have a trigger time.
+                 */
+                int64 maxLatency;
+
+                /**
+                 * The mean time from setting the source to entering its handler in nanoseconds.
+                 */
+                int64 meanLatency;
+            };
+
+            /**
+             * The maximum number of call sites of disabling all maskable interrupts.
+             */
+            static const int32 SITES = 32;
+
+            /**
+             * Statistics of a call site of disabling all maskable interrupts.
+             *
+             * The statistics are collected only if EOOS_ENABLE_INTERRUPT_PROFILER is defined.
+             */
+            struct Site
+            {
+                /**
+                 * The return address of the disabling.
+                 */
+                const void* address;
+
+                /**
+                 * The number of outermost regions.
+                 */
+                int64 count;
+
+                /**
+                 * The longest region in nanoseconds.
+                 */
+                int64 maxTime;
+            };
             
             /** 
              * Constructor.
@@ -75,21 +187,152 @@ namespace local
             /**
              * Disables all maskable interrupts.
              *
-             * @return global interrupts enable bit value before method was called.
+             * A thread gets the true status from each call, as the kernel counts the nesting
+             * of its critical sections, and an interrupt service routine gets the true status
+             * from the outermost call only.
+             *
+             * @return true if the enabling with the status leaves the disabling.
              */
             static bool disableAll();
+
+            /**
+             * Disables all maskable interrupts on behalf of a call site.
+             *
+             * A wrapper passes the return address of its caller, so the region
+             * is attributed to the caller of the wrapper.
+             *
+             * @param site the call site of the disabling.
+             * @return true if the enabling with the status leaves the disabling.
+             */
+            static bool disableAll(const void* site);
             
             /**
              * Enables all maskable interrupts.
              *
-             * The true passed argument directly turns all maskable interrupts on, 
-             * and the false does nothing, the interrupts stay in the current state.     
+             * The true passed argument leaves a disabling, and the false does nothing,
+             * the interrupts stay in the current state. The calls must be balanced with
+             * the disabling ones.
              *
              * @param status the returned status by disable method.
              */
             static void enableAll(bool status=true);        
+
+            /**
+             * Returns the longest time all maskable interrupts have been disabled.
+             *
+             * The time is measured by the system clock only if EOOS_ENABLE_INTERRUPT_PROFILER is defined.
+             *
+             * @return time in nanoseconds, or zero if the measurement is disabled.
+             */
+            static int64 getMaxDisabledTime();
+
+            /**
+             * Copies statistics of call sites of disabling all maskable interrupts.
+             *
+             * @param sites a buffer for statistics.
+             * @param count the maximum number of sites to copy.
+             * @return the number of sites copied.
+             */
+            static int32 getSites(Site* sites, int32 count);
+
+            /**
+             * Returns the number of regions of call sites which have not fit the site table.
+             *
+             * @return the number of regions.
+             */
+            static int64 getLost();
+
+
+            /**
+             * Services an interrupt source.
+             *
+             * The method is called by the interrupt vector of the source.
+             *
+             * @param source an interrupt source.
+             */
+            static void dispatch(int32 source);
+
+            /**
+             * Returns the vector of an interrupt source for an interrupt vector table.
+             *
+             * @param source an interrupt source.
+             * @return the vector which dispatches the source, or NULL if the source is not available.
+             */
+            static Vector getVector(int32 source);
+
+
+            /**
+             * Copies statistics of an interrupt source.
+             *
+             * @param source an interrupt source.
+             * @param stats  the statistics.
+             * @return true if the statistics have been copied.
+             */
+            static bool getStatistics(int32 source, Statistics& stats);
+
+            /**
+             * Tests if the execution is in an interrupt service routine.
+             *
+             * @return true if an interrupt is being serviced.
+             */
+            static bool isInterrupt();
+
+            /**
+             * Returns the current core.
+             *
+             * @return the core number.
+             */
+            static int32 getCore()
+            {
+                #if defined(configNUMBER_OF_CORES) && configNUMBER_OF_CORES > 1
+                return static_cast<int32>( portGET_CORE_ID() );
+                #else
+                return 0;
+                #endif
+            }
         
         private:
+
+            /**
+             * Running totals of the statistics of an interrupt source.
+             */
+            struct Totals
+            {
+                /**
+                 * The number of triggers of the source.
+                 */
+                int64 triggers;
+
+                /**
+                 * The number of handler executions.
+                 */
+                int64 executions;
+
+                /**
+                 * The maximum handler duration in nanoseconds.
+                 */
+                int64 maxDuration;
+
+                /**
+                 * The total handler duration in nanoseconds.
+                 */
+                int64 duration;
+
+                /**
+                 * The number of latency samples.
+                 */
+                int64 latencies;
+
+                /**
+                 * The maximum latency in nanoseconds.
+                 */
+                int64 maxLatency;
+
+                /**
+                 * The total latency in nanoseconds.
+                 */
+                int64 latency;
+            };
           
             /**
              * Constructor.
@@ -114,6 +357,155 @@ namespace local
              * @return reference to this object.     
              */
             Interrupt& operator =(const Interrupt& obj);
+
+            /**
+             * Masks all maskable interrupts without profiling.
+             *
+             * @return true if the unmasking with the status leaves the masking.
+             */
+            static bool mask();
+
+            /**
+             * Unmasks all maskable interrupts without profiling.
+             *
+             * @param status the returned status by mask method.
+             */
+            static void unmask(bool status);
+
+            /**
+             * Triggers this source.
+             */
+            void trigger();
+
+            /**
+             * Services an interrupt source which is available.
+             *
+             * @param source an interrupt source.
+             */
+            static void service(int32 source);
+
+            /**
+             * Dispatches an interrupt source.
+             *
+             * The trampolines are instantiated where the service method is inlined,
+             * so a trampoline is a direct vector of its source without the range check.
+             *
+             * @param S an interrupt source.
+             */
+            template <int32 S>
+            static void vector()
+            {
+                service(S);
+            }
+
+            #ifdef EOOS_PORT_POSIX
+
+            /**
+             * Dispatches a POSIX signal.
+             *
+             * @param signal a signal number.
+             */
+            static void handleSignal(int signal);
+
+            #endif // EOOS_PORT_POSIX
+
+            /**
+             * The source of this resource.
+             */
+            int32 source_;
+
+            /**
+             * The interrupt masks saved by the outermost disabling in an interrupt service routine of the cores.
+             */
+            static UBaseType_t mask_[CORES];
+
+            /**
+             * The cores, which interrupt service routines have disabled the interrupts.
+             */
+            static bool isMasked_[CORES];
+
+            /**
+             * The handlers of the sources.
+             */
+            static api::Task* handlers_[SOURCES];
+
+            /**
+             * The trampolines of the sources.
+             */
+            static const Vector vectors_[SOURCES];
+
+            /**
+             * The enabled sources.
+             */
+            static Atomic<uint32> enabled_;
+
+            /**
+             * The pending sources.
+             */
+            static Atomic<uint32> pending_;
+
+            /**
+             * The nesting depth of dispatching sources.
+             */
+            static volatile int32 context_;
+
+            #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+
+            /**
+             * The nesting depths of disabling all maskable interrupts of the cores.
+             */
+            static int32 depth_[CORES];
+
+            /**
+             * The times of the outermost disabling of the cores.
+             */
+            static int64 disabledAt_[CORES];
+
+            /**
+             * The longest time all maskable interrupts have been disabled.
+             */
+            static int64 maxDisabledTime_;
+
+            /**
+             * Registers a region of a call site.
+             *
+             * @param site the call site of the disabling.
+             * @param time the region time in nanoseconds.
+             */
+            static void measured(const void* site, int64 time);
+
+            /**
+             * The call sites of the outermost disabling of the cores.
+             */
+            static const void* site_[CORES];
+
+            /**
+             * The statistics of call sites.
+             */
+            static Site sites_[SITES];
+
+            /**
+             * The number of call sites.
+             */
+            static Atomic<int32> length_;
+
+            /**
+             * The number of regions of call sites which have not fit the site table.
+             */
+            static int64 lost_;
+
+
+            /**
+             * The running totals of the statistics of the sources.
+             */
+            static Totals totals_[SOURCES];
+
+            /**
+             * The times the sources have been set by software at.
+             */
+            static int64 triggeredAt_[SOURCES];
+
+            #endif // EOOS_ENABLE_INTERRUPT_PROFILER
         
         };
     }
@@ -0,0 +1,41 @@
+/**
+ * Listener of scheduling latency.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_LATENCY_LISTENER_HPP_
+#define SYSTEM_LATENCY_LISTENER_HPP_
+
+#include "Types.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class LatencyListener
+        {
+
+        public:
+
+            /**
+             * Destructor.
+             */
+            virtual ~LatencyListener()
+            {
+            }
+
+            /**
+             * Notifies a latency exceeding a threshold.
+             *
+             * The method is called by the monitor thread, so it must return quickly.
+             *
+             * @param latency the latency in nanoseconds.
+             */
+            virtual void exceeded(int64 latency) = 0;
+
+        };
+    }
+}
+#endif // SYSTEM_LATENCY_LISTENER_HPP_
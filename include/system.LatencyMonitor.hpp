@@ -0,0 +1,207 @@
+/**
+ * Scheduling latency monitor class.
+ *
+ * The monitor thread wakes up periodically, and measures the difference between
+ * the actual and the intended wake-up time by the system clock. The intended time
+ * of each wake-up is the time the monitor has been armed at plus a whole number of
+ * periods, so the latencies do not accumulate. The thread arms the monitor at a tick
+ * boundary, which it reaches by sleeping for one tick, and sleeps
+ * for the ticks left to each intended time by the system clock, so the intended
+ * and the actual times are taken from one clock, even if the ticks drift from it
+ * as the simulated ticks of a POSIX host do. The monitor keeps minimum, mean and maximum
+ * latencies, and a histogram of latencies on a logarithmic scale, and notifies
+ * a listener of every latency which exceeds a threshold.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_LATENCY_MONITOR_HPP_
+#define SYSTEM_LATENCY_MONITOR_HPP_
+
+#include "system.Object.hpp"
+#include "api.Resource.hpp"
+#include "system.Atomic.hpp"
+#include "system.LatencyListener.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
+
+namespace local
+{
+    namespace system
+    {
+        class LatencyMonitor : public system::Object, public api::Resource
+        {
+            typedef system::LatencyMonitor Self;
+            typedef system::Object         Parent;
+
+        public:
+
+            /**
+             * The number of histogram buckets.
+             */
+            static const int32 BUCKETS = 32;
+
+            /**
+             * Statistics of latencies.
+             */
+            struct Statistics
+            {
+                /**
+                 * The number of wake-ups.
+                 */
+                int64 count;
+
+                /**
+                 * The minimum latency in nanoseconds.
+                 */
+                int64 min;
+
+                /**
+                 * The mean latency in nanoseconds.
+                 */
+                int64 mean;
+
+                /**
+                 * The maximum latency in nanoseconds.
+                 */
+                int64 max;
+
+                /**
+                 * The number of latencies in each bucket.
+                 *
+                 * A bucket I counts latencies from 2^I to 2^(I+1) - 1 nanoseconds,
+                 * and the first bucket counts also latencies less than one nanosecond.
+                 */
+                int64 histogram[BUCKETS];
+            };
+
+            /**
+             * Constructor.
+             *
+             * @param period    a period of wake-ups in milliseconds.
+             * @param priority  a priority of the monitor thread.
+             * @param threshold a latency in nanoseconds, exceeding which is notified.
+             * @param listener  a listener of exceeding latencies, or NULL.
+             */
+            LatencyMonitor(int64 period, int32 priority, int64 threshold, LatencyListener* listener);
+
+            /**
+             * Destructor.
+             */
+            virtual ~LatencyMonitor();
+
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            virtual bool isConstructed() const;
+
+            /**
+             * Tests if this resource is blocked.
+             *
+             * @return true if a latency has exceeded the threshold.
+             */
+            virtual bool isBlocked() const;
+
+            /**
+             * Copies the statistics.
+             *
+             * @param stats the statistics.
+             */
+            void getStatistics(Statistics& stats) const;
+
+            /**
+             * Resets the statistics.
+             */
+            void reset();
+
+        private:
+
+            /**
+             * The stack size of the thread in words.
+             */
+            static const uint16 STACK_SIZE = configMINIMAL_STACK_SIZE * 2;
+
+            /**
+             * Constructor.
+             *
+             * @param priority a priority of the monitor thread.
+             * @return true if object has been constructed successfully.
+             */
+            bool construct(int32 priority);
+
+            /**
+             * Registers a latency.
+             *
+             * @param latency a latency in nanoseconds.
+             */
+            void measured(int64 latency);
+
+            /**
+             * Wakes up periodically, and measures latencies.
+             *
+             * @param argument the monitor.
+             */
+            static void main(void* argument);
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            LatencyMonitor(const LatencyMonitor& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            LatencyMonitor& operator =(const LatencyMonitor& obj);
+
+            /**
+             * The period of wake-ups in ticks.
+             */
+            TickType_t period_;
+
+            /**
+             * The threshold latency.
+             */
+            int64 threshold_;
+
+            /**
+             * The listener of exceeding latencies.
+             */
+            LatencyListener* listener_;
+
+            /**
+             * The thread.
+             */
+            TaskHandle_t task_;
+
+            /**
+             * The thread is requested to stop.
+             */
+            Atomic<bool> isStopping_;
+
+            /**
+             * The thread has stopped.
+             */
+            Atomic<bool> isStopped_;
+
+            /**
+             * A latency has exceeded the threshold.
+             */
+            Atomic<bool> isExceeded_;
+
+            /**
+             * The statistics, which keep the total latency instead of the mean one.
+             */
+            Statistics stats_;
+
+        };
+    }
+}
+#endif // SYSTEM_LATENCY_MONITOR_HPP_
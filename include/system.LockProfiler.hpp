@@ -0,0 +1,206 @@
+/**
+ * Contention profiler of a lock.
+ *
+ * The profiler collects statistics only if EOOS_ENABLE_LOCK_PROFILER is defined,
+ * otherwise it keeps a lock name only, and all its hooks are compiled to nothing.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_LOCK_PROFILER_HPP_
+#define SYSTEM_LOCK_PROFILER_HPP_
+
+#include "Types.hpp"
+#include "system.Interrupt.hpp"
+#include "system.Clock.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class LockProfiler
+        {
+            typedef system::LockProfiler Self;
+
+        public:
+
+            /**
+             * Statistics of a lock.
+             */
+            struct Statistics
+            {
+                /**
+                 * The lock name.
+                 */
+                const char* name;
+
+                /**
+                 * The number of acquisitions.
+                 */
+                int64 acquisitions;
+
+                /**
+                 * The number of acquisitions which have waited for the lock.
+                 */
+                int64 contentions;
+
+                /**
+                 * The total time of waiting for the lock in nanoseconds.
+                 */
+                int64 waitTime;
+
+                /**
+                 * The maximum time of waiting for the lock in nanoseconds.
+                 */
+                int64 maxWaitTime;
+
+                /**
+                 * The maximum time of holding the lock in nanoseconds.
+                 *
+                 * The time is zero for semaphores, as they have no owner.
+                 */
+                int64 maxHoldTime;
+            };
+
+            /**
+             * Constructor.
+             *
+             * @param name a lock name, or NULL.
+             */
+            explicit LockProfiler(const char* name);
+
+            /**
+             * Destructor.
+             */
+            ~LockProfiler();
+
+            /**
+             * Returns the lock name.
+             *
+             * @return the name, or NULL if the lock has no name.
+             */
+            const char* getName() const
+            {
+                return name_;
+            }
+
+            /**
+             * Returns a time stamp for profiling.
+             *
+             * @return time in nanoseconds, or zero if the profiler is disabled.
+             */
+            static int64 getTime()
+            {
+                #ifdef EOOS_ENABLE_LOCK_PROFILER
+                return Clock::getTime();
+                #else
+                return 0;
+                #endif
+            }
+
+            /**
+             * Registers an acquisition of the lock.
+             *
+             * @param time        a time stamp taken before waiting.
+             * @param isContended true if the lock has been waited for.
+             */
+            void acquired(int64 time, bool isContended)
+            {
+                #ifdef EOOS_ENABLE_LOCK_PROFILER
+                int64 const now = getTime();
+                bool const is = Interrupt::disableAll();
+                stats_.acquisitions++;
+                if(isContended)
+                {
+                    int64 const wait = now - time;
+                    stats_.contentions++;
+                    stats_.waitTime += wait;
+                    if(stats_.maxWaitTime < wait)
+                    {
+                        stats_.maxWaitTime = wait;
+                    }
+                }
+                lockedAt_ = now;
+                Interrupt::enableAll(is);
+                #else
+                static_cast<void>(time);
+                static_cast<void>(isContended);
+                #endif
+            }
+
+            /**
+             * Registers a release of the lock by its owner.
+             */
+            void released()
+            {
+                #ifdef EOOS_ENABLE_LOCK_PROFILER
+                int64 const hold = getTime() - lockedAt_;
+                if(stats_.maxHoldTime < hold)
+                {
+                    stats_.maxHoldTime = hold;
+                }
+                #endif
+            }
+
+            /**
+             * Copies statistics of the hottest locks.
+             *
+             * The locks are ordered by total waiting time descending.
+             *
+             * @param stats an array for the statistics.
+             * @param count the array length.
+             * @return the number of copied statistics.
+             */
+            static int32 getHottest(Statistics* stats, int32 count);
+
+        private:
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            LockProfiler(const LockProfiler& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            LockProfiler& operator =(const LockProfiler& obj);
+
+            /**
+             * The lock name.
+             */
+            const char* name_;
+
+            #ifdef EOOS_ENABLE_LOCK_PROFILER
+
+            /**
+             * The lock statistics.
+             */
+            Statistics stats_;
+
+            /**
+             * The time of the last acquisition.
+             */
+            int64 lockedAt_;
+
+            /**
+             * Next profiler of the profilers list.
+             */
+            LockProfiler* next_;
+
+            /**
+             * The first profiler of the profilers list.
+             */
+            static LockProfiler* head_;
+
+            #endif // EOOS_ENABLE_LOCK_PROFILER
+
+        };
+    }
+}
+#endif // SYSTEM_LOCK_PROFILER_HPP_
@@ -0,0 +1,86 @@
+/**
+ * Static memory layout of the operating system.
+ *
+ * The layout is the compile-time configuration of the static memory, which the
+ * system allocator takes if EOOS_ENABLE_STATIC_MEMORY is defined. Each constant
+ * is set by its macro, or has the default value:
+ *
+ * EOOS_STATIC_THREADS     - kernel threads, including the idle one, which is 8;
+ * EOOS_STATIC_STACK_SIZE  - stack size of a thread in words, which is 256;
+ * EOOS_STATIC_OBJECTS     - kernel control blocks and system resources, which is 64;
+ * EOOS_STATIC_OBJECT_SIZE - size of an object in bytes, which is 128;
+ * EOOS_STATIC_BUFFERS     - queue and message buffers, which is 8;
+ * EOOS_STATIC_BUFFER_SIZE - size of a buffer in bytes, which is 2048.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_MEMORY_LAYOUT_HPP_
+#define SYSTEM_MEMORY_LAYOUT_HPP_
+
+#include "Types.hpp"
+
+#ifndef EOOS_STATIC_THREADS
+#define EOOS_STATIC_THREADS 8
+#endif
+
+#ifndef EOOS_STATIC_STACK_SIZE
+#define EOOS_STATIC_STACK_SIZE 256
+#endif
+
+#ifndef EOOS_STATIC_OBJECTS
+#define EOOS_STATIC_OBJECTS 64
+#endif
+
+#ifndef EOOS_STATIC_OBJECT_SIZE
+#define EOOS_STATIC_OBJECT_SIZE 128
+#endif
+
+#ifndef EOOS_STATIC_BUFFERS
+#define EOOS_STATIC_BUFFERS 8
+#endif
+
+#ifndef EOOS_STATIC_BUFFER_SIZE
+#define EOOS_STATIC_BUFFER_SIZE 2048
+#endif
+
+namespace local
+{
+    namespace system
+    {
+        struct MemoryLayout
+        {
+            /**
+             * The number of kernel threads, including the idle one.
+             */
+            static const int32 THREADS = EOOS_STATIC_THREADS;
+
+            /**
+             * The stack size of a thread in words.
+             */
+            static const int32 STACK_SIZE = EOOS_STATIC_STACK_SIZE;
+
+            /**
+             * The number of kernel control blocks and system resources.
+             */
+            static const int32 OBJECTS = EOOS_STATIC_OBJECTS;
+
+            /**
+             * The size of an object in bytes.
+             */
+            static const int32 OBJECT_SIZE = EOOS_STATIC_OBJECT_SIZE;
+
+            /**
+             * The number of queue and message buffers.
+             */
+            static const int32 BUFFERS = EOOS_STATIC_BUFFERS;
+
+            /**
+             * The size of a buffer in bytes.
+             */
+            static const int32 BUFFER_SIZE = EOOS_STATIC_BUFFER_SIZE;
+        };
+    }
+}
+#endif // SYSTEM_MEMORY_LAYOUT_HPP_
@@ -0,0 +1,231 @@
+/**
+ * Zero-copy message buffer class.
+ *
+ * The buffer passes variable-length messages from one sender thread to one
+ * receiver thread. The sender reserves space for a message in the buffer,
+ * fills it in place and commits it, and the receiver reads the message in place
+ * and releases it, so a message is never copied by the buffer. Each message
+ * is stored as a contiguous frame with a length word, and a frame which does
+ * not fit at the end of the buffer is placed at its beginning.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_MESSAGE_BUFFER_HPP_
+#define SYSTEM_MESSAGE_BUFFER_HPP_
+
+#include "system.Object.hpp"
+#include "api.Resource.hpp"
+#include "system.Atomic.hpp"
+#include "system.WaitQueue.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class MessageBuffer : public system::Object, public api::Resource
+        {
+            typedef system::MessageBuffer Self;
+            typedef system::Object        Parent;
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param capacity the buffer size in bytes, which is rounded up to a power of two.
+             */
+            explicit MessageBuffer(size_t capacity);
+
+            /**
+             * Destructor.
+             */
+            virtual ~MessageBuffer();
+
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            virtual bool isConstructed() const;
+
+            /**
+             * Reserves space for a message, and sleeps until the buffer has the space.
+             *
+             * @param size the maximum size of the message in bytes.
+             * @return the address of the message space, or NULL if an error has been occurred.
+             */
+            void* reserve(size_t size);
+
+            /**
+             * Reserves space for a message if the buffer has the space.
+             *
+             * @param size the maximum size of the message in bytes.
+             * @return the address of the message space, or NULL if the buffer has no space.
+             */
+            void* tryReserve(size_t size);
+
+            /**
+             * Passes the reserved message to the receiver.
+             *
+             * @param size the actual size of the message, which does not exceed the reserved size.
+             */
+            void commit(size_t size);
+
+            /**
+             * Reads a message, and sleeps until the buffer has a message.
+             *
+             * @param size the size of the message in bytes.
+             * @return the address of the message, or NULL if an error has been occurred.
+             */
+            const void* read(size_t& size);
+
+            /**
+             * Reads a message if the buffer has a message.
+             *
+             * @param size the size of the message in bytes.
+             * @return the address of the message, or NULL if the buffer is empty.
+             */
+            const void* tryRead(size_t& size);
+
+            /**
+             * Returns the space of the read message to the sender.
+             */
+            void release();
+
+            /**
+             * Returns the maximum size of a message.
+             *
+             * @return the size in bytes.
+             */
+            size_t getMaxSize() const;
+
+            /**
+             * Tests if this resource is blocked.
+             *
+             * @return true if the buffer is empty.
+             */
+            virtual bool isBlocked() const;
+
+        private:
+
+            /**
+             * The length word of a frame which skips the buffer end.
+             */
+            static const uint32 SKIP = 0xFFFFFFFF;
+
+            /**
+             * Constructor.
+             *
+             * @param capacity the buffer size in bytes.
+             * @return true if object has been constructed successfully.
+             */
+            bool construct(size_t capacity);
+
+            /**
+             * Places a frame for a message.
+             *
+             * @param size the size of the message in bytes.
+             * @return the address of the message space, or NULL if the buffer has no space.
+             */
+            void* place(size_t size);
+
+            /**
+             * Finds the frame of the next message.
+             *
+             * @param size the size of the message in bytes.
+             * @return the address of the message, or NULL if the buffer is empty.
+             */
+            const void* find(size_t& size);
+
+            /**
+             * Wakes up a thread waiting in a queue.
+             *
+             * @param queue   a wait queue.
+             * @param waiters the number of threads in the wait queue.
+             */
+            static void wake(WaitQueue& queue, Atomic<int32>& waiters);
+
+            /**
+             * Returns a frame size of a message.
+             *
+             * @param size the size of the message in bytes.
+             * @return the frame size aligned to the length word.
+             */
+            static uint32 toFrame(size_t size);
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            MessageBuffer(const MessageBuffer& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            MessageBuffer& operator =(const MessageBuffer& obj);
+
+            /**
+             * The buffer memory.
+             */
+            uint8* buf_;
+
+            /**
+             * The buffer size.
+             */
+            uint32 capacity_;
+
+            /**
+             * The total number of bytes committed by the sender.
+             */
+            Atomic<uint32> written_;
+
+            /**
+             * The total number of bytes released by the receiver.
+             */
+            Atomic<uint32> read_;
+
+            /**
+             * The number of bytes skipped and reserved by the sender.
+             */
+            uint32 reserved_;
+
+            /**
+             * The number of bytes skipped before the reserved frame.
+             */
+            uint32 skipped_;
+
+            /**
+             * The number of bytes skipped and read by the receiver.
+             */
+            uint32 pending_;
+
+            /**
+             * The number of threads waiting for space.
+             */
+            Atomic<int32> senders_;
+
+            /**
+             * The number of threads waiting for messages.
+             */
+            Atomic<int32> receivers_;
+
+            /**
+             * The thread waiting for space.
+             */
+            WaitQueue sendQueue_;
+
+            /**
+             * The thread waiting for messages.
+             */
+            WaitQueue receiveQueue_;
+
+        };
+    }
+}
+#endif // SYSTEM_MESSAGE_BUFFER_HPP_
@@ -1,5 +1,17 @@
 /**
  * Mutex class.
+ *
+ * The mutex has a lock word which is changed by atomic operations,
+ * and a binary semaphore of the kernel which is used for sleeping
+ * only if the mutex is contended. Thus, locking and unlocking a free
+ * mutex do not call the kernel at all.
+ *
+ * The kernel does not know an owner of such a mutex, so the mutex does not
+ * inherit priorities, and a low priority owner can be preempted by medium
+ * priority threads while a high priority thread waits for it. A mutex which
+ * is shared by threads of different priorities is created inheriting. It is
+ * a mutex of the kernel, which is called on every locking and unlocking,
+ * and which raises the priority of an owner to the priority of a waiter.
  * 
  * @author    Sergey Baigudin, sergey@baigudin.software
  * @copyright 2017-2018, Embedded Team, Sergey Baigudin
@@ -10,6 +22,13 @@
 
 #include "system.Object.hpp"
 #include "api.Mutex.hpp"
+#include "system.Atomic.hpp"
+#include "system.Timeout.hpp"
+#include "system.LockProfiler.hpp"
+#include "system.Trace.hpp"
+#include "system.Holder.hpp"
+#include "FreeRTOS.h"
+#include "semphr.h"
 
 namespace local
 {
@@ -19,23 +38,49 @@ namespace local
         {
             typedef system::Mutex  Self;
             typedef system::Object Parent;
-      
+
+            #ifdef EOOS_DISABLE_CONSTRUCTION_CHECKS
+
+        private:
+
+            /**
+             * The owners, which test the construction of a mutex before it is used.
+             */
+            friend class System;
+            friend class Holder<Mutex>;
+
+            #else
+
         public:
+
+            #endif // EOOS_DISABLE_CONSTRUCTION_CHECKS
       
             /** 
              * Constructor.
+             *
+             * @param name         a name of the mutex for profiling, or NULL.
+             * @param isInheriting true if the mutex inherits priorities, and calls the kernel always.
              */    
-            Mutex() : Parent()
-            {
+            explicit Mutex(const char* name=NULL, bool isInheriting=false) : Parent(),
+                lock_         (UNLOCKED),
+                sem_          (NULL),
+                isInheriting_ (isInheriting),
+                profiler_     (name){
                 bool const isConstructed = construct();
                 setConstructed( isConstructed );              
             }        
+
+        public:
             
             /** 
              * Destructor.
              */      
             virtual ~Mutex()
             {
+                if(sem_ != NULL)
+                {
+                    vSemaphoreDelete(sem_);
+                }
             }        
                 
             /**
@@ -56,8 +101,36 @@ namespace local
              */      
             virtual bool lock()
             {
-                if( not Self::isConstructed() ) return false;
-                return false;
+                if( not Self::isUsable() ) return false;
+                if( tryTake() ) return true;
+                return take(NULL);
+            }
+            
+            /**
+             * Locks the mutex if it is free.
+             *
+             * The method never calls the kernel.
+             *
+             * @return true if the mutex is lock successfully.
+             */      
+            bool tryLock()
+            {
+                if( not Self::isUsable() ) return false;
+                return tryTake();
+            }
+            
+            /**
+             * Locks the mutex, or gives up when a timeout expires.
+             *
+             * @param millis a time to wait in milliseconds.
+             * @return true if the mutex is lock successfully.
+             */      
+            bool tryLock(int64 millis)
+            {
+                if( not Self::isUsable() ) return false;
+                if( tryTake() ) return true;
+                Timeout timeout(millis);
+                return take(&timeout);
             }
             
             /**
@@ -65,7 +138,21 @@ namespace local
              */      
             virtual void unlock()
             {
-                if( not Self::isConstructed() ) return;
+                if( not Self::isUsable() ) return;
+                profiler_.released();
+                Trace::record(Trace::MUTEX_UNLOCK, this);
+                if(isInheriting_)
+                {
+                    lock_.store(UNLOCKED);
+                    // The kernel restores the priority of the owner
+                    static_cast<void>( xSemaphoreGive(sem_) );
+                    return;
+                }
+                // Only a contended mutex has threads which sleep on the semaphore
+                if( lock_.exchange(UNLOCKED) == CONTENDED )
+                {
+                    static_cast<void>( xSemaphoreGive(sem_) );
+                }
             }
             
             /** 
@@ -75,11 +162,36 @@ namespace local
              */ 
             virtual bool isBlocked()const
             {
-                if( not Self::isConstructed() ) return false;
-                return false;
+                if( not Self::isUsable() ) return false;
+                return lock_.load() != UNLOCKED;
+            }
+            
+            /** 
+             * Tests if this mutex inherits priorities.
+             *
+             * @return true if this mutex inherits priorities.
+             */ 
+            bool isInheriting() const
+            {
+                return isInheriting_;
             }
       
         private:
+        
+            /**
+             * The mutex is not locked.
+             */
+            static const int32 UNLOCKED = 0;
+            
+            /**
+             * The mutex is locked, and no one waits for it.
+             */
+            static const int32 LOCKED = 1;
+            
+            /**
+             * The mutex is locked, and some threads might wait for it.
+             */
+            static const int32 CONTENDED = 2;
       
             /**
              * Constructor.
@@ -89,6 +201,73 @@ namespace local
             bool construct()
             {
                 if( not Self::isConstructed() ) return false;
+                sem_ = isInheriting_ ? xSemaphoreCreateMutex() : xSemaphoreCreateBinary();
+                if(sem_ == NULL) return false;
+                return true;
+            }
+            
+            /**
+             * Locks the mutex if it is free.
+             *
+             * @return true if the mutex is lock successfully.
+             */      
+            bool tryTake()
+            {
+                bool isTaken;
+                if(isInheriting_)
+                {
+                    isTaken = xSemaphoreTake(sem_, 0) == pdTRUE;
+                    if(isTaken)
+                    {
+                        lock_.store(LOCKED);
+                    }
+                }
+                else
+                {
+                    isTaken = lock_.compareAndSwap(UNLOCKED, LOCKED);
+                }
+                if(isTaken)
+                {
+                    profiler_.acquired(0, false);
+                    Trace::record(Trace::MUTEX_LOCK, this);
+                }
+                return isTaken;
+            }
+            
+            /**
+             * Marks the mutex contended, and sleeps until an owner unlocks it.
+             *
+             * @param timeout a timeout, or NULL to wait forever.
+             * @return true if the mutex is lock successfully.
+             */      
+            bool take(Timeout* timeout)
+            {
+                int64 const time = LockProfiler::getTime();
+                Trace::record(Trace::MUTEX_WAIT, this);
+                if(isInheriting_)
+                {
+                    // The kernel raises the priority of the owner while this thread waits
+                    TickType_t const ticks = timeout == NULL ? portMAX_DELAY : timeout->getTicks();
+                    if( xSemaphoreTake(sem_, ticks) != pdTRUE ) return false;
+                    lock_.store(LOCKED);
+                    profiler_.acquired(time, true);
+                    Trace::record(Trace::MUTEX_LOCK, this);
+                    return true;
+                }
+                while( lock_.exchange(CONTENDED) != UNLOCKED )
+                {
+                    if(timeout == NULL)
+                    {
+                        if( xSemaphoreTake(sem_, portMAX_DELAY) != pdTRUE ) return false;
+                    }
+                    else
+                    {
+                        if( timeout->isExpired() ) return false;
+                        static_cast<void>( xSemaphoreTake(sem_, timeout->getTicks()) );
+                    }
+                }
+                profiler_.acquired(time, true);
+                Trace::record(Trace::MUTEX_LOCK, this);
                 return true;
             }
             
@@ -106,6 +285,26 @@ namespace local
              * @return reference to this object.     
              */
             Mutex& operator =(const Mutex& obj);
+            
+            /**
+             * The lock word.
+             */
+            Atomic<int32> lock_;
+            
+            /**
+             * The kernel semaphore for sleeping on a contended mutex, or the kernel mutex of an inheriting one.
+             */
+            SemaphoreHandle_t sem_;
+            
+            /**
+             * The mutex inherits priorities.
+             */
+            bool isInheriting_;
+            
+            /**
+             * The contention profiler.
+             */
+            LockProfiler profiler_;
       
         };
     }
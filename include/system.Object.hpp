@@ -1,5 +1,14 @@
 /** 
  * Root class of the operating system class hierarchy.
+ *
+ * Methods of resources test the resources have been constructed before they
+ * are used. If EOOS_DISABLE_CONSTRUCTION_CHECKS is defined, the tests are
+ * compiled away, and a resource is used only once it has been fully constructed.
+ * The factories of the operating system return constructed resources only. The
+ * mutex and the semaphore have no public constructors then, and are held
+ * statically or on a stack by a holder, which gives them only once constructed.
+ * Another resource which is constructed statically or on a stack must be tested
+ * by the isConstructed method once before it is used.
  * 
  * @author    Sergey Baigudin, sergey@baigudin.software
  * @copyright 2014-2018, Embedded Team, Sergey Baigudin
@@ -30,6 +39,22 @@ namespace local
              * Destructor.
              */    
             virtual ~Object();       
+
+        protected:
+
+            /**
+             * Tests if this object can be used.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            bool isUsable() const
+            {
+                #ifdef EOOS_DISABLE_CONSTRUCTION_CHECKS
+                return true;
+                #else
+                return Parent::isConstructed();
+                #endif
+            }
         
         };
     }
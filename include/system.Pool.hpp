@@ -0,0 +1,159 @@
+/**
+ * Fixed-size block memory pool class.
+ *
+ * The pool has static storage of a number of blocks of one size. Blocks are
+ * taken from a list of freed blocks, or from the never used part of the
+ * storage, so the pool needs no constructor, and a pool of static duration
+ * is usable before any constructor is called. Allocating and freeing take
+ * a few loads and stores, and the caller serializes them. The pool marks its
+ * allocated blocks in a bitmap, so freeing an address which is not the
+ * beginning of a block, or a block which is free, is rejected.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_POOL_HPP_
+#define SYSTEM_POOL_HPP_
+
+#include "Types.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * @param S size of a block in bytes.
+         * @param N number of blocks.
+         */
+        template <int32 S, int32 N>
+        class Pool
+        {
+            typedef system::Pool<S,N> Self;
+
+            /**
+             * The compilation fails if the pool is empty.
+             */
+            typedef char PoolIsNotEmpty[ ( S > 0 && N > 0 ) ? 1 : -1 ];
+
+        public:
+
+            /**
+             * The size of a block in bytes, which is rounded up to eight bytes.
+             */
+            static const size_t BLOCK_SIZE = ( static_cast<size_t>(S) + 7 ) & ~static_cast<size_t>(7);
+
+            /**
+             * The size of the storage in bytes.
+             */
+            static const size_t SIZE = BLOCK_SIZE * N;
+
+            /**
+             * Allocates a block.
+             *
+             * @return the block address, or NULL if all blocks are allocated.
+             */
+            void* allocate()
+            {
+                void* block = free_;
+                if(block != NULL)
+                {
+                    free_ = free_->next;
+                }
+                else if(used_ < N)
+                {
+                    block = blocks_[used_++];
+                }
+                else
+                {
+                    return NULL;
+                }
+                int32 const index = getIndex(block);
+                allocated_[index >> 5] |= static_cast<uint32>(1) << (index & 31);
+                return block;
+            }
+
+            /**
+             * Frees a block.
+             *
+             * @param ptr the block address, which must be contained by this pool.
+             * @return true if the block has been freed, or false if the address is not an allocated block.
+             */
+            bool free(void* const ptr)
+            {
+                const uint8* const addr = static_cast<const uint8*>(ptr);
+                const uint8* const begin = reinterpret_cast<const uint8*>(blocks_);
+                if( static_cast<size_t>(addr - begin) % BLOCK_SIZE != 0 ) return false;
+                int32 const index = getIndex(ptr);
+                uint32 const bit = static_cast<uint32>(1) << (index & 31);
+                if( (allocated_[index >> 5] & bit) == 0 ) return false;
+                allocated_[index >> 5] &= ~bit;
+                Node* const node = static_cast<Node*>(ptr);
+                node->next = free_;
+                free_ = node;
+                return true;
+            }
+
+            /**
+             * Tests if a memory is a block of this pool.
+             *
+             * @param ptr a memory address.
+             * @return true if the memory is a block of this pool.
+             */
+            bool contains(const void* const ptr) const
+            {
+                const uint8* const addr = static_cast<const uint8*>(ptr);
+                const uint8* const begin = reinterpret_cast<const uint8*>(blocks_);
+                return addr >= begin && addr < begin + SIZE;
+            }
+
+        private:
+
+            /**
+             * Returns the index of a block.
+             *
+             * @param ptr the block address.
+             * @return the block index.
+             */
+            int32 getIndex(const void* const ptr) const
+            {
+                const uint8* const addr = static_cast<const uint8*>(ptr);
+                const uint8* const begin = reinterpret_cast<const uint8*>(blocks_);
+                return static_cast<int32>( static_cast<size_t>(addr - begin) / BLOCK_SIZE );
+            }
+
+            /**
+             * A free block.
+             */
+            struct Node
+            {
+                /**
+                 * The next free block.
+                 */
+                Node* next;
+            };
+
+            /**
+             * The list of freed blocks.
+             */
+            Node* free_;
+
+            /**
+             * The number of blocks taken from the storage.
+             */
+            int32 used_;
+
+            /**
+             * The bits of the allocated blocks.
+             */
+            uint32 allocated_[(N + 31) / 32];
+
+            /**
+             * The storage.
+             */
+            uint64 blocks_[N][BLOCK_SIZE / sizeof(uint64)];
+
+        };
+    }
+}
+#endif // SYSTEM_POOL_HPP_
@@ -0,0 +1,244 @@
+/**
+ * Bounded message queue class.
+ *
+ * The queue is a ring of cells with sequence numbers, which lets any number of
+ * senders and receivers pass messages by atomic operations only. Threads sleep
+ * in wait queues of the queue only if it is full or empty, so the queue does not
+ * create kernel objects, and calls the kernel only for waking sleeping threads.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_QUEUE_HPP_
+#define SYSTEM_QUEUE_HPP_
+
+#include "system.Object.hpp"
+#include "api.Resource.hpp"
+#include "system.Atomic.hpp"
+#include "system.WaitQueue.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class Queue : public system::Object, public api::Resource
+        {
+            typedef system::Queue  Self;
+            typedef system::Object Parent;
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param capacity the maximum number of messages, which is rounded up to a power of two.
+             * @param size     the size of a message in bytes.
+             */
+            Queue(int32 capacity, size_t size);
+
+            /**
+             * Destructor.
+             */
+            virtual ~Queue();
+
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            virtual bool isConstructed() const;
+
+            /**
+             * Sends a message, and sleeps until the queue has space for it.
+             *
+             * @param msg a message to copy to the queue.
+             * @return true if the message has been sent.
+             */
+            bool send(const void* msg);
+
+            /**
+             * Sends a message if the queue has space for it.
+             *
+             * @param msg a message to copy to the queue.
+             * @return true if the message has been sent.
+             */
+            bool trySend(const void* msg);
+
+            /**
+             * Sends messages while the queue has space for them.
+             *
+             * @param msgs  an array of messages to copy to the queue.
+             * @param count the number of messages in the array.
+             * @return the number of sent messages.
+             */
+            int32 trySend(const void* msgs, int32 count);
+
+            /**
+             * Sends a message from an interrupt service routine if the queue has space for it.
+             *
+             * @param msg a message to copy to the queue.
+             * @return true if the message has been sent.
+             */
+            bool sendFromInterrupt(const void* msg);
+
+            /**
+             * Receives a message, and sleeps until the queue has a message.
+             *
+             * @param msg a buffer to copy a message to.
+             * @return true if a message has been received.
+             */
+            bool receive(void* msg);
+
+            /**
+             * Receives a message if the queue has a message.
+             *
+             * @param msg a buffer to copy a message to.
+             * @return true if a message has been received.
+             */
+            bool tryReceive(void* msg);
+
+            /**
+             * Receives messages while the queue has them.
+             *
+             * @param msgs  an array to copy messages to.
+             * @param count the number of messages the array can hold.
+             * @return the number of received messages.
+             */
+            int32 tryReceive(void* msgs, int32 count);
+
+            /**
+             * Returns the number of messages in the queue.
+             *
+             * @return the number of messages.
+             */
+            int32 getLength() const;
+
+            /**
+             * Returns the maximum number of messages in the queue.
+             *
+             * @return the capacity.
+             */
+            int32 getCapacity() const;
+
+            /**
+             * Tests if this resource is blocked.
+             *
+             * @return true if the queue is empty, or is full.
+             */
+            virtual bool isBlocked() const;
+
+        private:
+
+            /**
+             * Constructor.
+             *
+             * @param capacity the maximum number of messages.
+             * @param size     the size of a message in bytes.
+             * @return true if object has been constructed successfully.
+             */
+            bool construct(int32 capacity, size_t size);
+
+            /**
+             * Copies a message to the queue.
+             *
+             * @param msg a message.
+             * @return true if the message has been copied.
+             */
+            bool push(const void* msg);
+
+            /**
+             * Copies a message from the queue.
+             *
+             * @param msg a buffer for a message.
+             * @return true if the message has been copied.
+             */
+            bool pop(void* msg);
+
+            /**
+             * Wakes up threads waiting in a queue.
+             *
+             * @param queue   a wait queue.
+             * @param waiters the number of threads in the wait queue.
+             * @param count   the maximum number of threads to wake up.
+             */
+            static void wake(WaitQueue& queue, Atomic<int32>& waiters, int32 count);
+
+            /**
+             * Copies memory.
+             *
+             * @param dst  a destination address.
+             * @param src  a source address.
+             * @param size a number of bytes.
+             */
+            static void copy(void* dst, const void* src, size_t size);
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            Queue(const Queue& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            Queue& operator =(const Queue& obj);
+
+            /**
+             * The sequence numbers of the cells.
+             */
+            Atomic<uint32>* seqs_;
+
+            /**
+             * The messages of the cells.
+             */
+            uint8* msgs_;
+
+            /**
+             * The size of a message.
+             */
+            size_t size_;
+
+            /**
+             * The mask of a cell index.
+             */
+            uint32 mask_;
+
+            /**
+             * The position of the next message to receive.
+             */
+            Atomic<uint32> head_;
+
+            /**
+             * The position of the next message to send.
+             */
+            Atomic<uint32> tail_;
+
+            /**
+             * The number of threads waiting for space.
+             */
+            Atomic<int32> senders_;
+
+            /**
+             * The number of threads waiting for messages.
+             */
+            Atomic<int32> receivers_;
+
+            /**
+             * The threads waiting for space.
+             */
+            WaitQueue sendQueue_;
+
+            /**
+             * The threads waiting for messages.
+             */
+            WaitQueue receiveQueue_;
+
+        };
+    }
+}
+#endif // SYSTEM_QUEUE_HPP_
@@ -0,0 +1,293 @@
+/**
+ * Reader-writer lock class.
+ *
+ * The lock has a state word which holds the number of readers and a writer bit.
+ * Readers and writers acquire and release a free lock by atomic operations
+ * on the word, and sleep in wait queues of the lock only if it is contended.
+ * If writers are preferred, readers do not acquire the lock while a writer
+ * waits for it, otherwise readers are never delayed by waiting writers.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_READ_WRITE_LOCK_HPP_
+#define SYSTEM_READ_WRITE_LOCK_HPP_
+
+#include "system.Object.hpp"
+#include "api.Resource.hpp"
+#include "system.Interrupt.hpp"
+#include "system.Atomic.hpp"
+#include "system.WaitQueue.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class ReadWriteLock : public system::Object, public api::Resource
+        {
+            typedef system::ReadWriteLock Self;
+            typedef system::Object        Parent;
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param isWriterPreferred true if waiting writers go ahead of new readers.
+             */
+            explicit ReadWriteLock(bool isWriterPreferred) : Parent(),
+                state_             (0),
+                writers_           (0),
+                waiters_           (0),
+                readerQueue_       (true),
+                writerQueue_       (true),
+                isWriterPreferred_ (isWriterPreferred){
+                bool const isConstructed = construct();
+                setConstructed( isConstructed );
+            }
+
+            /**
+             * Destructor.
+             */
+            virtual ~ReadWriteLock()
+            {
+            }
+
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            virtual bool isConstructed() const
+            {
+                return Parent::isConstructed();
+            }
+
+            /**
+             * Locks the lock for reading.
+             *
+             * @return true if the lock is lock successfully.
+             */
+            bool lockRead()
+            {
+                if( not Self::isConstructed() ) return false;
+                if( tryRead() ) return true;
+                WaitQueue::Waiter waiter(READER);
+                bool const is = Interrupt::disableAll();
+                static_cast<void>( waiters_.add(1) );
+                bool const isLocked = tryRead();
+                if(isLocked)
+                {
+                    static_cast<void>( waiters_.subtract(1) );
+                }
+                else
+                {
+                    readerQueue_.add(waiter);
+                }
+                Interrupt::enableAll(is);
+                if( not isLocked )
+                {
+                    // The lock is passed to the waiter by a releasing thread
+                    WaitQueue::wait(waiter);
+                }
+                return true;
+            }
+
+            /**
+             * Unlocks the lock locked for reading.
+             */
+            void unlockRead()
+            {
+                if( not Self::isConstructed() ) return;
+                // Only the last reader might unblock a writer
+                if( state_.subtract(1) != 1 ) return;
+                if( waiters_.load() == 0 ) return;
+                bool const is = Interrupt::disableAll();
+                grant();
+                Interrupt::enableAll(is);
+            }
+
+            /**
+             * Locks the lock for writing.
+             *
+             * @return true if the lock is lock successfully.
+             */
+            bool lockWrite()
+            {
+                if( not Self::isConstructed() ) return false;
+                if( state_.compareAndSwap(0, WRITER) ) return true;
+                WaitQueue::Waiter waiter(WRITER);
+                bool const is = Interrupt::disableAll();
+                static_cast<void>( writers_.add(1) );
+                static_cast<void>( waiters_.add(1) );
+                bool const isLocked = state_.compareAndSwap(0, WRITER);
+                if(isLocked)
+                {
+                    static_cast<void>( waiters_.subtract(1) );
+                    static_cast<void>( writers_.subtract(1) );
+                }
+                else
+                {
+                    writerQueue_.add(waiter);
+                }
+                Interrupt::enableAll(is);
+                if( not isLocked )
+                {
+                    // The lock is passed to the waiter by a releasing thread
+                    WaitQueue::wait(waiter);
+                }
+                return true;
+            }
+
+            /**
+             * Unlocks the lock locked for writing.
+             */
+            void unlockWrite()
+            {
+                if( not Self::isConstructed() ) return;
+                state_.store(0);
+                if( waiters_.load() == 0 ) return;
+                bool const is = Interrupt::disableAll();
+                grant();
+                Interrupt::enableAll(is);
+            }
+
+            /**
+             * Tests if this lock prefers writers.
+             *
+             * @return true if waiting writers go ahead of new readers.
+             */
+            bool isWriterPreferred() const
+            {
+                return isWriterPreferred_;
+            }
+
+            /**
+             * Tests if this resource is blocked.
+             *
+             * @return true if this resource is blocked.
+             */
+            virtual bool isBlocked() const
+            {
+                if( not Self::isConstructed() ) return false;
+                return state_.load() != 0;
+            }
+
+        private:
+
+            /**
+             * The request value of waiting readers.
+             */
+            static const int32 READER = 1;
+
+            /**
+             * The state bit of a writer holding the lock.
+             */
+            static const int32 WRITER = 0x40000000;
+
+            /**
+             * Constructor.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            bool construct()
+            {
+                if( not Self::isConstructed() ) return false;
+                return true;
+            }
+
+            /**
+             * Locks the lock for reading if a writer neither holds nor takes precedence.
+             *
+             * @return true if the lock is lock successfully.
+             */
+            bool tryRead()
+            {
+                int32 state = state_.load();
+                while( (state & WRITER) == 0 )
+                {
+                    if( isWriterPreferred_ && writers_.load() != 0 ) break;
+                    if( state_.compareAndSwap(state, state + 1) ) return true;
+                    state = state_.load();
+                }
+                return false;
+            }
+
+            /**
+             * Passes the lock to waiting threads.
+             *
+             * The method must be called with disabled interrupts.
+             */
+            void grant()
+            {
+                while(true)
+                {
+                    int32 const state = state_.load();
+                    if( (state & WRITER) != 0 ) break;
+                    bool const isWriter = not writerQueue_.isEmpty() && ( isWriterPreferred_ || readerQueue_.isEmpty() );
+                    if(isWriter)
+                    {
+                        if(state != 0) break;
+                        if( not state_.compareAndSwap(0, WRITER) ) continue;
+                        static_cast<void>( waiters_.subtract(1) );
+                        static_cast<void>( writers_.subtract(1) );
+                        writerQueue_.signalFirst();
+                        break;
+                    }
+                    if( readerQueue_.isEmpty() ) break;
+                    if( not state_.compareAndSwap(state, state + 1) ) continue;
+                    static_cast<void>( waiters_.subtract(1) );
+                    readerQueue_.signalFirst();
+                }
+            }
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            ReadWriteLock(const ReadWriteLock& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            ReadWriteLock& operator =(const ReadWriteLock& obj);
+
+            /**
+             * The number of readers and the writer bit.
+             */
+            Atomic<int32> state_;
+
+            /**
+             * The number of waiting writers.
+             */
+            Atomic<int32> writers_;
+
+            /**
+             * The number of threads in the wait queues.
+             */
+            Atomic<int32> waiters_;
+
+            /**
+             * The readers waiting for the lock.
+             */
+            WaitQueue readerQueue_;
+
+            /**
+             * The writers waiting for the lock.
+             */
+            WaitQueue writerQueue_;
+
+            /**
+             * The writer preference of this lock.
+             */
+            bool const isWriterPreferred_;
+
+        };
+    }
+}
+#endif // SYSTEM_READ_WRITE_LOCK_HPP_
@@ -0,0 +1,263 @@
+/**
+ * Single-producer single-consumer ring buffer class.
+ *
+ * The buffer hands data over from one producer, which is usually an interrupt
+ * service routine, to one consumer thread. Pushing is wait-free and takes
+ * a few loads and stores, and the kernel is called only if the buffer has been
+ * empty and the consumer sleeps on it. The buffer has static storage, and
+ * does not allocate memory.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_RING_BUFFER_HPP_
+#define SYSTEM_RING_BUFFER_HPP_
+
+#include "Types.hpp"
+#include "system.Atomic.hpp"
+#include "system.Timeout.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * @param T data type of buffer element.
+         * @param L maximum number of buffer elements, which must be a power of two.
+         */
+        template <typename T, int32 L>
+        class RingBuffer
+        {
+            typedef system::RingBuffer<T,L> Self;
+
+            /**
+             * The compilation fails if the length is not a power of two.
+             */
+            typedef char LengthIsPowerOfTwo[ ( L > 0 && (L & (L - 1)) == 0 ) ? 1 : -1 ];
+
+        public:
+
+            /**
+             * Constructor.
+             */
+            RingBuffer() :
+                head_      (0),
+                tail_      (0),
+                isWaiting_ (false),
+                consumer_  (NULL){
+            }
+
+            /**
+             * Destructor.
+             */
+            ~RingBuffer()
+            {
+            }
+
+            /**
+             * Pushes an element from an interrupt service routine.
+             *
+             * @param value an element.
+             * @return true if the element has been pushed, or false if the buffer is full.
+             */
+            bool pushFromInterrupt(const T& value)
+            {
+                bool wasEmpty;
+                if( not put(value, wasEmpty) ) return false;
+                // Only the first element after the buffer has been empty wakes the consumer
+                if( wasEmpty && isWaiting_.exchange(false) )
+                {
+                    BaseType_t isWoken = pdFALSE;
+                    vTaskNotifyGiveFromISR(consumer_, &isWoken);
+                    portYIELD_FROM_ISR(isWoken);
+                }
+                return true;
+            }
+
+            /**
+             * Pushes an element from a thread.
+             *
+             * @param value an element.
+             * @return true if the element has been pushed, or false if the buffer is full.
+             */
+            bool push(const T& value)
+            {
+                bool wasEmpty;
+                if( not put(value, wasEmpty) ) return false;
+                if( wasEmpty && isWaiting_.exchange(false) )
+                {
+                    static_cast<void>( xTaskNotifyGive(consumer_) );
+                }
+                return true;
+            }
+
+            /**
+             * Pops elements.
+             *
+             * @param values an array for elements.
+             * @param count  the array length.
+             * @return the number of popped elements.
+             */
+            int32 pop(T* values, int32 count)
+            {
+                if(values == NULL) return 0;
+                uint32 const head = head_.load();
+                uint32 const length = tail_.load() - head;
+                uint32 const number = static_cast<uint32>(count) < length ? static_cast<uint32>(count) : length;
+                for(uint32 i=0; i<number; i++)
+                {
+                    values[i] = buf_[(head + i) & MASK];
+                }
+                // Free the cells only after the elements have been copied
+                head_.store(head + number);
+                return static_cast<int32>(number);
+            }
+
+            /**
+             * Pops elements, and sleeps until the buffer has an element.
+             *
+             * @param values an array for elements.
+             * @param count  the array length.
+             * @return the number of popped elements.
+             */
+            int32 wait(T* values, int32 count)
+            {
+                int32 number = pop(values, count);
+                while(number == 0 && count > 0)
+                {
+                    if( sleep(portMAX_DELAY) )
+                    {
+                        number = pop(values, count);
+                    }
+                }
+                return number;
+            }
+
+            /**
+             * Pops elements, and sleeps until the buffer has an element or a timeout expires.
+             *
+             * @param values an array for elements.
+             * @param count  the array length.
+             * @param millis a time to wait in milliseconds.
+             * @return the number of popped elements.
+             */
+            int32 wait(T* values, int32 count, int64 millis)
+            {
+                int32 number = pop(values, count);
+                if(number != 0 || count < 1) return number;
+                Timeout timeout(millis);
+                while( not timeout.isExpired() )
+                {
+                    if( sleep(timeout.getTicks()) )
+                    {
+                        number = pop(values, count);
+                        if(number != 0) break;
+                    }
+                }
+                return number;
+            }
+
+            /**
+             * Tests if the buffer is empty.
+             *
+             * @return true if the buffer has no elements.
+             */
+            bool isEmpty() const
+            {
+                return tail_.load() == head_.load();
+            }
+
+        private:
+
+            /**
+             * The mask of an element index.
+             */
+            static const uint32 MASK = static_cast<uint32>(L) - 1;
+
+            /**
+             * Puts an element to the buffer.
+             *
+             * @param value    an element.
+             * @param wasEmpty set to true if the buffer has been empty.
+             * @return true if the element has been put.
+             */
+            bool put(const T& value, bool& wasEmpty)
+            {
+                uint32 const tail = tail_.load();
+                uint32 const head = head_.load();
+                if( tail - head == static_cast<uint32>(L) ) return false;
+                buf_[tail & MASK] = value;
+                // Publish the element only after it has been copied
+                tail_.store(tail + 1);
+                // Test after the publication, as the consumer might empty the buffer meanwhile
+                wasEmpty = head_.load() == tail;
+                return true;
+            }
+
+            /**
+             * Sleeps until the producer pushes an element to the empty buffer.
+             *
+             * @param ticks the kernel ticks to sleep.
+             * @return true if the buffer might have elements.
+             */
+            bool sleep(TickType_t ticks)
+            {
+                consumer_ = xTaskGetCurrentTaskHandle();
+                // Announce the waiting before the last test, as the producer
+                // either sees the waiting, or its element is seen by the test
+                isWaiting_.store(true);
+                if( not isEmpty() )
+                {
+                    isWaiting_.store(false);
+                    return true;
+                }
+                return ulTaskNotifyTake(pdTRUE, ticks) != 0;
+            }
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            RingBuffer(const RingBuffer& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            RingBuffer& operator =(const RingBuffer& obj);
+
+            /**
+             * The position of the next element to pop.
+             */
+            Atomic<uint32> head_;
+
+            /**
+             * The position of the next element to push.
+             */
+            Atomic<uint32> tail_;
+
+            /**
+             * The consumer sleeps on the buffer.
+             */
+            Atomic<bool> isWaiting_;
+
+            /**
+             * The kernel task of the consumer.
+             */
+            TaskHandle_t consumer_;
+
+            /**
+             * The buffer elements.
+             */
+            T buf_[L];
+
+        };
+    }
+}
+#endif // SYSTEM_RING_BUFFER_HPP_
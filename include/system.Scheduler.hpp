@@ -12,6 +12,8 @@
 #include "api.Scheduler.hpp"
 #include "system.GlobalThread.hpp"
 #include "library.LinkedList.hpp"
+#include "system.Interrupt.hpp"
+#include "Error.hpp"
 
 namespace local
 {
@@ -54,6 +56,8 @@ namespace local
             /**
              * Returns currently executing thread.
              *
+             * The method is defined in this header, so the static dispatch inlines it into a caller.
+             *
              * @return executing thread.
              */
             virtual api::Thread& getCurrentThread() const;
@@ -96,6 +100,13 @@ namespace local
              * @return true if object has been constructed successfully.
              */
             bool construct();
+
+            /**
+             * Terminates the operating system execution.
+             *
+             * @param error a termination status code.
+             */
+            static void terminate(Error error);
             
             /**
              * Copy constructor.
@@ -125,4 +136,42 @@ namespace local
         };
     }
 }
+
+// The threads are complete types only after the scheduler
+#include "system.SchedulerThread.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Returns currently executing thread.
+         *
+         * @return executing thread.
+         */
+        inline api::Thread& Scheduler::getCurrentThread() const
+        {
+            if( not Self::isUsable() ) 
+            {
+                terminate(ERROR_SYSCALL_CALLED);
+            }
+            bool const is = Interrupt::disableAll();
+            api::Thread* thread = NULL;
+            int64 id = -1; // TODO: get a current thread ID static_cast<int64>( gettid() );
+            int32 length = threads_.getLength();
+            for(int32 i=0; i<length; i++)
+            {
+                thread = threads_.get(i);
+                if(thread == NULL) break;
+                if(thread->getId() == id) break;
+            }
+            Interrupt::enableAll(is);
+            if(thread == NULL) 
+            {
+                terminate(ERROR_RESOURCE_NOT_FOUND);
+            }
+            return *thread;
+        }
+    }
+}
 #endif // SYSTEM_SCHEDULER_HPP_
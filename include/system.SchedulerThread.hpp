@@ -13,6 +13,7 @@
 #include "api.Task.hpp"
 #include "system.Semaphore.hpp"
 #include "system.Interrupt.hpp"
+#include "system.Trace.hpp"
 
 namespace local
 {
@@ -64,12 +65,13 @@ namespace local
              */
             virtual void execute()
             {
-                if( not Self::isConstructed() ) return;
+                if( not Self::isUsable() ) return;
                 if( status_ != NEW ) return;
                 bool is = Interrupt::disableAll();
                 scheduler_->addThread(this);
                 status_ = RUNNABLE;                     
                 Interrupt::enableAll(is);            
+                Trace::record(Trace::THREAD_START, this);
                 sem_.release();
             }       
             
@@ -78,7 +80,7 @@ namespace local
              */  
             virtual void join()
             {
-                if( not Self::isConstructed() ) return;             
+                if( not Self::isUsable() ) return;             
                 // TODO: prc_join(res_);
             }
             
@@ -90,7 +92,7 @@ namespace local
              */  
             virtual void sleep(int64 millis, int32 nanos)
             {
-                if( not Self::isConstructed() ) return;
+                if( not Self::isUsable() ) return;
                 if(millis == 0)
                 {
                     // int32 micros = nanos / 1000;
@@ -113,7 +115,7 @@ namespace local
              */  
             virtual void block(api::Resource& res)
             {
-                if( not Self::isConstructed() ) return;
+                if( not Self::isUsable() ) return;
             }        
             
             /**
@@ -152,7 +154,7 @@ namespace local
              */  
             virtual Status getStatus() const
             {
-                return Self::isConstructed() ? status_ : DEAD;
+                return Self::isUsable() ? status_ : DEAD;
             }      
             
         private:
@@ -1,5 +1,14 @@
 /**
  * Semaphore class.
+ *
+ * The permits are counted by atomic operations, and threads which cannot
+ * acquire permits sleep in a wait queue of the semaphore. An unfair semaphore
+ * queues its threads by priority as the kernel does, and lets an acquiring
+ * thread take a free permit ahead of the queue. A fair semaphore queues its
+ * threads in arrival order, and never lets a thread overtake the queue.
+ * Any number of permits is acquired or released by one atomic operation,
+ * and the permits which the first thread of the queue waits for are reserved
+ * for it, so the thread cannot be starved by threads acquiring fewer permits.
  * 
  * @author    Sergey Baigudin, sergey@baigudin.software
  * @copyright 2017-2018, Embedded Team, Sergey Baigudin
@@ -11,6 +20,12 @@
 #include "system.Object.hpp"
 #include "api.Semaphore.hpp"
 #include "system.Interrupt.hpp"
+#include "system.Atomic.hpp"
+#include "system.WaitQueue.hpp"
+#include "system.Timeout.hpp"
+#include "system.LockProfiler.hpp"
+#include "system.Trace.hpp"
+#include "system.Holder.hpp"
 
 namespace local
 {
@@ -20,19 +35,59 @@ namespace local
         {
             typedef system::Semaphore Self;
             typedef system::Object    Parent;
-    
+
+            #ifdef EOOS_DISABLE_CONSTRUCTION_CHECKS
+
+        private:
+
+            /**
+             * The owners, which test the construction of a semaphore before it is used.
+             */
+            friend class System;
+            friend class SchedulerThread;
+            friend class Holder<Semaphore>;
+
+            #else
+
         public:
+
+            #endif // EOOS_DISABLE_CONSTRUCTION_CHECKS
     
             /** 
              * Constructor.
              *
              * @param permits the initial number of permits available.   
              */      
-            Semaphore(int32 permits) : Parent()
-            {
-                bool const isConstructed = construct(permits);
+            Semaphore(int32 permits) : Parent(),
+                permits_  (permits),
+                reserve_  (0),
+                waiters_  (0),
+                queue_    (false),
+                isFair_   (false),
+                profiler_ (NULL){
+                bool const isConstructed = construct();
+                setConstructed( isConstructed );                
+            }   
+            
+            /** 
+             * Constructor.
+             *
+             * @param permits the initial number of permits available.   
+             * @param isFair  true if this semaphore will guarantee FIFO granting of permits under contention.
+             * @param name    a name of the semaphore for profiling, or NULL.
+             */      
+            Semaphore(int32 permits, bool isFair, const char* name=NULL) : Parent(),
+                permits_  (permits),
+                reserve_  (0),
+                waiters_  (0),
+                queue_    (isFair),
+                isFair_   (isFair),
+                profiler_ (name){
+                bool const isConstructed = construct();
                 setConstructed( isConstructed );                
             }   
+
+        public:
     
             /** 
              * Destructor.
@@ -58,8 +113,8 @@ namespace local
              */  
             virtual bool acquire()
             {
-                if( not Self::isConstructed() ) return false;        
-                return false;
+                if( not Self::isUsable() ) return false;        
+                return take(1);
             }        
     
             /**
@@ -70,8 +125,53 @@ namespace local
              */  
             virtual bool acquire(int32 permits)
             {
-                if( not Self::isConstructed() ) return false;
-                return false;
+                if( not Self::isUsable() ) return false;
+                if( permits < 1 ) return false;
+                return take(permits);
+            }
+            
+            /**
+             * Acquires one permit if it is available.
+             *
+             * The method never calls the kernel if the semaphore is not contended.
+             *
+             * @return true if the semaphore is acquired successfully.
+             */  
+            bool tryAcquire()
+            {
+                if( not Self::isUsable() ) return false;
+                return tryTake(1);
+            }
+            
+            /**
+             * Acquires the given number of permits if they are available.
+             *
+             * The method never calls the kernel if the semaphore is not contended.
+             *
+             * @param permits the number of permits to acquire.
+             * @return true if the semaphore is acquired successfully.
+             */  
+            bool tryAcquire(int32 permits)
+            {
+                if( not Self::isUsable() ) return false;
+                if( permits < 1 ) return false;
+                return tryTake(permits);
+            }
+            
+            /**
+             * Acquires the given number of permits, or gives up when a timeout expires.
+             *
+             * @param permits the number of permits to acquire.
+             * @param millis  a time to wait in milliseconds.
+             * @return true if the semaphore is acquired successfully.
+             */  
+            bool tryAcquire(int32 permits, int64 millis)
+            {
+                if( not Self::isUsable() ) return false;
+                if( permits < 1 ) return false;
+                if( tryTake(permits) ) return true;
+                Timeout timeout(millis);
+                return take(permits, &timeout);
             }
     
             /**
@@ -79,7 +179,8 @@ namespace local
              */
             virtual void release()
             {
-                if( not Self::isConstructed() ) return;        
+                if( not Self::isUsable() ) return;        
+                give(1);
             } 
     
             /**
@@ -89,7 +190,9 @@ namespace local
              */  
             virtual void release(int32 permits)
             {
-                if( not Self::isConstructed() ) return;
+                if( not Self::isUsable() ) return;
+                if( permits < 1 ) return;
+                give(permits);
             }         
     
             /**
@@ -99,7 +202,7 @@ namespace local
              */  
             virtual bool isFair() const
             {
-                return false;
+                return isFair_;
             }        
     
             /** 
@@ -109,8 +212,8 @@ namespace local
              */ 
             virtual bool isBlocked() const
             {
-                if( not Self::isConstructed() ) return false;
-                return false;
+                if( not Self::isUsable() ) return false;
+                return permits_.load() < 1;
             }
     
         private:
@@ -118,15 +221,184 @@ namespace local
             /**
              * Constructor.
              *
-             * @param permits the initial number of permits available.            
              * @return true if object has been constructed successfully.     
              */    
-            bool construct(int32 permits)
+            bool construct()
             {
                 if( not Self::isConstructed() ) return false;
                 return true;
             }
             
+            /**
+             * Acquires permits, and sleeps until they are available.
+             *
+             * @param permits the number of permits to acquire.
+             * @return true if the semaphore is acquired successfully.
+             */  
+            bool take(int32 permits)
+            {
+                if( tryTake(permits) ) return true;
+                return take(permits, NULL);
+            }
+            
+            /**
+             * Sleeps until permits are available.
+             *
+             * @param permits the number of permits to acquire.
+             * @param timeout a timeout, or NULL to wait forever.
+             * @return true if the semaphore is acquired successfully.
+             */  
+            bool take(int32 permits, Timeout* timeout)
+            {
+                int64 const time = LockProfiler::getTime();
+                Trace::record(Trace::SEMAPHORE_WAIT, this);
+                WaitQueue::Waiter waiter(permits);
+                bool const is = Interrupt::disableAll();
+                // Announce the waiter before the last try, as a releasing thread
+                // either sees the waiter, or its permits are seen by the try
+                static_cast<void>( waiters_.add(1) );
+                bool const isTaken = ( isFair_ && not queue_.isEmpty() ) ? false : decrement(permits, reserve_.load());
+                if(isTaken)
+                {
+                    static_cast<void>( waiters_.subtract(1) );
+                }
+                else
+                {
+                    queue_.add(waiter);
+                    reserve();
+                }
+                Interrupt::enableAll(is);
+                bool isGranted = isTaken;
+                if( not isGranted )
+                {
+                    if(timeout == NULL)
+                    {
+                        WaitQueue::wait(waiter);
+                        isGranted = true;
+                    }
+                    else
+                    {
+                        isGranted = WaitQueue::wait(waiter, *timeout) || leave(waiter);
+                    }
+                }
+                if(isGranted)
+                {
+                    profiler_.acquired(time, true);
+                    Trace::record(Trace::SEMAPHORE_ACQUIRE, this);
+                }
+                return isGranted;
+            }
+            
+            /**
+             * Removes a timed out thread from the wait queue.
+             *
+             * @param waiter the thread record.
+             * @return true if the permits have been granted to the thread before the removal.
+             */  
+            bool leave(WaitQueue::Waiter& waiter)
+            {
+                bool const is = Interrupt::disableAll();
+                bool const isGranted = not queue_.remove(waiter);
+                if( not isGranted )
+                {
+                    static_cast<void>( waiters_.subtract(1) );
+                    // The leaving thread might hold a reserve, or block smaller requests 
+                    grant(NULL);
+                }
+                Interrupt::enableAll(is);
+                return isGranted;
+            }
+            
+            /**
+             * Acquires permits if they are available without waiting.
+             *
+             * @param permits the number of permits to acquire.
+             * @return true if the semaphore is acquired successfully.
+             */  
+            bool tryTake(int32 permits)
+            {
+                // A fair semaphore does not let a thread overtake waiting threads
+                if( isFair_ && waiters_.load() != 0 ) return false;
+                bool const isTaken = decrement(permits, reserve_.load());
+                if(isTaken)
+                {
+                    profiler_.acquired(0, false);
+                    Trace::record(Trace::SEMAPHORE_ACQUIRE, this);
+                }
+                return isTaken;
+            }
+            
+            /**
+             * Releases permits, and grants them to waiting threads.
+             *
+             * @param permits the number of permits to release.
+             */  
+            void give(int32 permits)
+            {
+                Trace::record(Trace::SEMAPHORE_RELEASE, this);
+                static_cast<void>( permits_.add(permits) );
+                if( waiters_.load() == 0 ) return;
+                // The permits might be released by an interrupt service routine
+                BaseType_t isWoken = pdFALSE;
+                BaseType_t* const woken = Interrupt::isInterrupt() ? &isWoken : NULL;
+                bool const is = Interrupt::disableAll();
+                grant(woken);
+                Interrupt::enableAll(is);
+                if(woken != NULL)
+                {
+                    portYIELD_FROM_ISR(isWoken);
+                }
+            }
+            
+            /**
+             * Grants available permits to waiting threads in the queue order.
+             *
+             * The method must be called with disabled interrupts.
+             *
+             * @param isWoken NULL if the caller is a thread, or a flag of an interrupt service routine.
+             */  
+            void grant(BaseType_t* isWoken)
+            {
+                WaitQueue::Waiter* waiter = queue_.getFirst();
+                while(waiter != NULL)
+                {
+                    if( not decrement(waiter->request, 0) ) break;
+                    static_cast<void>( waiters_.subtract(1) );
+                    queue_.signalFirst(isWoken);
+                    waiter = queue_.getFirst();
+                }
+                reserve();
+            }
+            
+            /**
+             * Reserves permits for the first waiting thread.
+             *
+             * The method must be called with disabled interrupts.
+             */  
+            void reserve()
+            {
+                WaitQueue::Waiter const* const waiter = queue_.getFirst();
+                reserve_.store( waiter != NULL ? waiter->request : 0 );
+            }
+            
+            /**
+             * Decrements available permits if there are enough of them.
+             *
+             * @param permits the number of permits to decrement.
+             * @param reserved the number of permits which must stay available.
+             * @return true if the permits have been decremented.
+             */  
+            bool decrement(int32 permits, int32 reserved)
+            {
+                int32 available = permits_.load();
+                while(available - reserved >= permits)
+                {
+                    if( permits_.compareAndSwap(available, available - permits) ) return true;
+                    available = permits_.load();
+                }
+                return false;
+            }
+            
             /**
              * Copy constructor.
              *
@@ -141,6 +413,36 @@ namespace local
              * @return reference to this object.     
              */
             Semaphore& operator =(const Semaphore& obj);            
+            
+            /**
+             * The number of available permits.
+             */
+            Atomic<int32> permits_;
+            
+            /**
+             * The number of permits reserved for the first waiting thread.
+             */
+            Atomic<int32> reserve_;
+            
+            /**
+             * The number of threads in the wait queue.
+             */
+            Atomic<int32> waiters_;
+            
+            /**
+             * The threads waiting for permits.
+             */
+            WaitQueue queue_;
+            
+            /**
+             * The fairness of this semaphore.
+             */
+            bool const isFair_;
+            
+            /**
+             * The contention profiler.
+             */
+            LockProfiler profiler_;
     
         };  
     }
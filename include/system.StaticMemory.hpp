@@ -0,0 +1,192 @@
+/**
+ * Static memory of the operating system.
+ *
+ * The memory is reserved statically by a compile-time configuration, which
+ * is a class of constants:
+ *
+ * struct Layout
+ * {
+ *     static const int32 THREADS     = 8;    // Kernel threads, including the idle one
+ *     static const int32 STACK_SIZE  = 256;  // Stack size of a thread in words
+ *     static const int32 OBJECTS     = 64;   // Kernel control blocks and system resources
+ *     static const int32 OBJECT_SIZE = 128;  // Size of an object in bytes
+ *     static const int32 BUFFERS     = 8;    // Queue and message buffers
+ *     static const int32 BUFFER_SIZE = 2048; // Size of a buffer in bytes
+ * };
+ *
+ * Each kind of memory has its pool of fixed-size blocks, and an allocation
+ * takes a block of the smallest size which fits it, or fails if all blocks of
+ * that size are allocated, so one kind of memory never exhausts another one.
+ * Freeing a memory which is not an allocated block of the pools, such as an
+ * address inside a block or a block freed twice, terminates the operating
+ * system. The compilation fails if the configuration does not fit the kernel.
+ *
+ * If EOOS_ENABLE_STATIC_MEMORY is defined, the system allocator takes the memory
+ * of the MemoryLayout configuration, and defines the kernel heap functions, so
+ * a zero-heap image is linked without a kernel heap. The memory has the fixed
+ * SIZE, so the memory map is checked at link time.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_STATIC_MEMORY_HPP_
+#define SYSTEM_STATIC_MEMORY_HPP_
+
+#include "system.Pool.hpp"
+#include "system.Interrupt.hpp"
+#include "system.System.hpp"
+#include "FreeRTOS.h"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * @param C compile-time configuration.
+         */
+        template <class C>
+        class StaticMemory
+        {
+            typedef system::StaticMemory<C> Self;
+
+            /**
+             * The pool of objects.
+             */
+            typedef Pool<C::OBJECT_SIZE, C::OBJECTS> Objects;
+
+            /**
+             * The pool of thread stacks.
+             */
+            typedef Pool<C::STACK_SIZE * static_cast<int32>( sizeof(StackType_t) ), C::THREADS> Stacks;
+
+            /**
+             * The pool of buffers.
+             */
+            typedef Pool<C::BUFFER_SIZE, C::BUFFERS> Buffers;
+
+            /**
+             * The compilation fails if a thread stack is less than the kernel minimal one.
+             */
+            typedef char StackFitsKernel[ ( C::STACK_SIZE >= configMINIMAL_STACK_SIZE ) ? 1 : -1 ];
+
+            /**
+             * The compilation fails if an object does not fit kernel control blocks.
+             */
+            typedef char ObjectFitsKernel[ ( Objects::BLOCK_SIZE >= sizeof(StaticTask_t) && Objects::BLOCK_SIZE >= sizeof(StaticQueue_t) ) ? 1 : -1 ];
+
+            /**
+             * The compilation fails if the block sizes do not increase from objects to stacks to buffers.
+             */
+            typedef char SizesIncrease[ ( Objects::BLOCK_SIZE <= Stacks::BLOCK_SIZE && Stacks::BLOCK_SIZE <= Buffers::BLOCK_SIZE ) ? 1 : -1 ];
+
+        public:
+
+            /**
+             * The size of the memory in bytes.
+             */
+            static const size_t SIZE = Objects::SIZE + Stacks::SIZE + Buffers::SIZE;
+
+            /**
+             * Allocates memory.
+             *
+             * @param size number of bytes to allocate.
+             * @return allocated memory address or a null pointer.
+             */
+            static void* allocate(size_t const size)
+            {
+                void* addr = NULL;
+                bool const is = Interrupt::disableAll();
+                if(size <= Objects::BLOCK_SIZE)
+                {
+                    addr = objects_.allocate();
+                }
+                else if(size <= Stacks::BLOCK_SIZE)
+                {
+                    addr = stacks_.allocate();
+                }
+                else if(size <= Buffers::BLOCK_SIZE)
+                {
+                    addr = buffers_.allocate();
+                }
+                else
+                {
+                    // The memory does not fit any block
+                }
+                Interrupt::enableAll(is);
+                return addr;
+            }
+
+            /**
+             * Frees an allocated memory.
+             *
+             * @param ptr address of allocated memory block or a null pointer.
+             */
+            static void free(void* const ptr)
+            {
+                if(ptr == NULL) return;
+                bool isFreed = false;
+                bool const is = Interrupt::disableAll();
+                if( objects_.contains(ptr) )
+                {
+                    isFreed = objects_.free(ptr);
+                }
+                else if( stacks_.contains(ptr) )
+                {
+                    isFreed = stacks_.free(ptr);
+                }
+                else if( buffers_.contains(ptr) )
+                {
+                    isFreed = buffers_.free(ptr);
+                }
+                else
+                {
+                    // The memory is not a block of the pools
+                }
+                Interrupt::enableAll(is);
+                // The memory has not been allocated by the pools, so the memory is corrupted
+                if( not isFreed )
+                {
+                    System::terminate(ERROR_UNDEFINED);
+                }
+            }
+
+        private:
+
+            /**
+             * The pool of objects.
+             */
+            static Objects objects_;
+
+            /**
+             * The pool of thread stacks.
+             */
+            static Stacks stacks_;
+
+            /**
+             * The pool of buffers.
+             */
+            static Buffers buffers_;
+
+        };
+
+        /**
+         * The pool of objects.
+         */
+        template <class C>
+        typename StaticMemory<C>::Objects StaticMemory<C>::objects_;
+
+        /**
+         * The pool of thread stacks.
+         */
+        template <class C>
+        typename StaticMemory<C>::Stacks StaticMemory<C>::stacks_;
+
+        /**
+         * The pool of buffers.
+         */
+        template <class C>
+        typename StaticMemory<C>::Buffers StaticMemory<C>::buffers_;
+    }
+}
+#endif // SYSTEM_STATIC_MEMORY_HPP_
@@ -0,0 +1,107 @@
+/**
+ * Static dispatch of the operating system calls.
+ *
+ * The operating system calls through the api interfaces are virtual, and the
+ * compiler cannot inline them. The class binds the calls to the system types
+ * at compile time, so the uncontended paths of locks and semaphores, and the
+ * lookups of the scheduler and the current thread, which are defined in the
+ * headers, are inlined into a caller. A caller must hold the
+ * resources by the system types, and must call the methods after the operating
+ * system has been constructed.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_SYSCALL_HPP_
+#define SYSTEM_SYSCALL_HPP_
+
+#include "system.System.hpp"
+#include "system.Mutex.hpp"
+#include "system.Semaphore.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class Syscall
+        {
+
+        public:
+
+            /**
+             * Returns the operating system.
+             *
+             * @return the operating system.
+             */
+            static System& getSystem()
+            {
+                return System::get();
+            }
+
+            /**
+             * Returns the kernel scheduler.
+             *
+             * @return the kernel scheduler.
+             */
+            static Scheduler& getScheduler()
+            {
+                return static_cast<Scheduler&>( System::get().System::getScheduler() );
+            }
+
+            /**
+             * Returns currently executing thread.
+             *
+             * @return executing thread.
+             */
+            static api::Thread& getCurrentThread()
+            {
+                return getScheduler().Scheduler::getCurrentThread();
+            }
+
+            /**
+             * Locks a mutex.
+             *
+             * @param mutex a mutex.
+             * @return true if the mutex is lock successfully.
+             */
+            static bool lock(Mutex& mutex)
+            {
+                return mutex.Mutex::lock();
+            }
+
+            /**
+             * Unlocks a mutex.
+             *
+             * @param mutex a mutex.
+             */
+            static void unlock(Mutex& mutex)
+            {
+                mutex.Mutex::unlock();
+            }
+
+            /**
+             * Acquires one permit from a semaphore.
+             *
+             * @param sem a semaphore.
+             * @return true if the semaphore is acquired successfully.
+             */
+            static bool acquire(Semaphore& sem)
+            {
+                return sem.Semaphore::acquire();
+            }
+
+            /**
+             * Releases one permit of a semaphore.
+             *
+             * @param sem a semaphore.
+             */
+            static void release(Semaphore& sem)
+            {
+                sem.Semaphore::release();
+            }
+
+        };
+    }
+}
+#endif // SYSTEM_SYSCALL_HPP_
@@ -22,6 +22,17 @@ namespace local
 {
     namespace system
     {
+        class ReadWriteLock;
+        class Queue;
+        class MessageBuffer;
+        class EventGroup;
+        class ConditionVariable;
+        class DeferredInterrupt;
+        class TraceExporter;
+        class TraceSink;
+        class LatencyMonitor;
+        class LatencyListener;
+        
         class System : public system::Object, public api::System
         {
             typedef system::System Self;
@@ -77,17 +88,48 @@ namespace local
             /**
              * Returns the kernel scheduler.
              *
+             * The method is defined here, so the static dispatch inlines it into a caller.
+             *
              * @return the kernel scheduler.
              */
-            virtual api::Scheduler& getScheduler() const;
+            virtual api::Scheduler& getScheduler() const
+            {
+                if( not Self::isUsable() )
+                {
+                    terminate(ERROR_SYSCALL_CALLED);
+                }
+                return scheduler_;
+            }
 
             /**
              * Creates a new mutex resource.
              *
+             * The mutex does not inherit priorities.
+             *
              * @return a new mutex resource, or NULL if an error has been occurred.
              */
             virtual api::Mutex* createMutex();
 
+            /**
+             * Creates a new named mutex resource.
+             *
+             * @param name - a name of the mutex for profiling.
+             * @return a new mutex resource, or NULL if an error has been occurred.
+             */
+            api::Mutex* createMutex(const char* name);
+
+            /**
+             * Creates a new named mutex resource, which might inherit priorities.
+             *
+             * A mutex which does not inherit priorities locks and unlocks without calling
+             * the kernel if it is not contended, and an inheriting one is a kernel mutex.
+             *
+             * @param name         - a name of the mutex for profiling, or NULL.
+             * @param isInheriting - true if the mutex raises the priority of its owner to the priority of a waiter.
+             * @return a new mutex resource, or NULL if an error has been occurred.
+             */
+            api::Mutex* createMutex(const char* name, bool isInheriting);
+
             /**
              * Creates a new semaphore resource.
              *
@@ -97,6 +139,16 @@ namespace local
              */
             virtual api::Semaphore* createSemaphore(int32 permits, bool isFair);
 
+            /**
+             * Creates a new named semaphore resource.
+             *
+             * @param permits - the initial number of permits available.
+             * @param isFair  - true if this semaphore will guarantee FIFO granting of permits under contention.
+             * @param name    - a name of the semaphore for profiling.
+             * @return a new semaphore resource, or NULL if an error has been occurred.
+             */
+            api::Semaphore* createSemaphore(int32 permits, bool isFair, const char* name);
+
             /**
              * Creates a new interrupt resource.
              *
@@ -106,6 +158,74 @@ namespace local
              */
             virtual api::Interrupt* createInterrupt(api::Task& handler, int32 source);
 
+            /**
+             * Creates a new deferred interrupt resource.
+             *
+             * @param handler - user class which implements an interrupt handler interface.
+             * @param source  - available interrupt source number.
+             * @return a new deferred interrupt resource, or NULL if an error has been occurred.
+             */
+            DeferredInterrupt* createDeferredInterrupt(api::Task& handler, int32 source);
+
+            /**
+             * Creates a new reader-writer lock resource.
+             *
+             * @param isWriterPreferred - true if waiting writers go ahead of new readers.
+             * @return a new reader-writer lock resource, or NULL if an error has been occurred.
+             */
+            ReadWriteLock* createReadWriteLock(bool isWriterPreferred);
+
+            /**
+             * Creates a new message queue resource.
+             *
+             * @param capacity - the maximum number of messages, which is rounded up to a power of two.
+             * @param size     - the size of a message in bytes.
+             * @return a new message queue resource, or NULL if an error has been occurred.
+             */
+            Queue* createQueue(int32 capacity, size_t size);
+
+            /**
+             * Creates a new zero-copy message buffer resource.
+             *
+             * @param capacity - the buffer size in bytes, which is rounded up to a power of two.
+             * @return a new message buffer resource, or NULL if an error has been occurred.
+             */
+            MessageBuffer* createMessageBuffer(size_t capacity);
+
+            /**
+             * Creates a new event flags resource.
+             *
+             * @return a new event flags resource, or NULL if an error has been occurred.
+             */
+            EventGroup* createEventGroup();
+
+            /**
+             * Creates a new condition variable resource.
+             *
+             * @return a new condition variable resource, or NULL if an error has been occurred.
+             */
+            ConditionVariable* createConditionVariable();
+
+            /**
+             * Creates a new trace exporter resource.
+             *
+             * @param sink   - a sink of the stream.
+             * @param period - a period of draining in milliseconds.
+             * @return a new trace exporter resource, or NULL if an error has been occurred.
+             */
+            TraceExporter* createTraceExporter(TraceSink& sink, int64 period);
+
+            /**
+             * Creates a new scheduling latency monitor resource.
+             *
+             * @param period    - a period of wake-ups in milliseconds.
+             * @param priority  - a priority of the monitor thread.
+             * @param threshold - a latency in nanoseconds, exceeding which is notified.
+             * @param listener  - a listener of exceeding latencies, or NULL.
+             * @return a new latency monitor resource, or NULL if an error has been occurred.
+             */
+            LatencyMonitor* createLatencyMonitor(int64 period, int32 priority, int64 threshold, LatencyListener* listener);
+
             /**
              * Terminates the operating system execution.
              */
@@ -125,6 +245,19 @@ namespace local
              */
             static api::System& call();
 
+            /**
+             * Returns the operating system without testing it has been constructed.
+             *
+             * The method is inlined, so it must be called after the operating
+             * system has been constructed successfully only.
+             *
+             * @return the operating system.
+             */
+            static System& get()
+            {
+                return *static_cast<System*>(system_);
+            }
+
             /**
              * Terminates the operating system execution.
              *
@@ -189,25 +322,50 @@ namespace local
             const Configuration config_;
 
             /**
-             * The operating system heap memory.
+             * The startup stage of the operating system executing CPU.
              */
-            mutable system::Heap heap_;
+            int32 const cpuStage_;
 
             /**
              * The operating system executing CPU.
              */
             mutable cpu::Cpu cpu_;
 
+            /**
+             * The startup stage of the operating system heap memory.
+             */
+            int32 const heapStage_;
+
+            /**
+             * The operating system heap memory.
+             */
+            mutable system::Heap heap_;
+
+            /**
+             * The startup stage of the operating system global interrupt controller.
+             */
+            int32 const giStage_;
+
             /**
              * The operating system global interrupt controller.
              */
             mutable system::GlobalInterrupt gi_;
 
+            /**
+             * The startup stage of the operating system runtime environment.
+             */
+            int32 const runtimeStage_;
+
             /**
              * The operating system runtime environment.
              */
             mutable system::Runtime runtime_;
 
+            /**
+             * The startup stage of the operating system scheduler.
+             */
+            int32 const schedulerStage_;
+
             /**
              * The operating system scheduler.
              */
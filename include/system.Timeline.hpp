@@ -0,0 +1,104 @@
+/**
+ * Startup timeline of the operating system.
+ *
+ * The timeline keeps the beginning time and the duration of each stage of
+ * the operating system bring-up, such as the construction of a subsystem,
+ * in order of beginning. The times are taken from the system clock,
+ * which starts at the beginning of the operating system construction, or
+ * at the kernel start if the clock counts the kernel ticks, so the stages
+ * passed before the kernel start have zero times then.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_TIMELINE_HPP_
+#define SYSTEM_TIMELINE_HPP_
+
+#include "Types.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class Timeline
+        {
+            typedef system::Timeline Self;
+
+        public:
+
+            /**
+             * The maximum number of stages.
+             */
+            static const int32 STAGES = 16;
+
+            /**
+             * A stage of the bring-up.
+             */
+            struct Stage
+            {
+                /**
+                 * The stage name.
+                 */
+                const char* name;
+
+                /**
+                 * The beginning time in nanoseconds.
+                 */
+                int64 begin;
+
+                /**
+                 * The duration in nanoseconds, or -1 if the stage has not ended.
+                 */
+                int64 duration;
+            };
+
+            /**
+             * Begins a stage.
+             *
+             * @param name a stage name, which must be a string literal.
+             * @return the stage index, or -1 if the timeline is full.
+             */
+            static int32 begin(const char* name);
+
+            /**
+             * Ends a stage.
+             *
+             * @param stage the stage index.
+             */
+            static void end(int32 stage);
+
+            /**
+             * Ends a stage, and begins a next one.
+             *
+             * @param stage the stage index.
+             * @param name  a next stage name, which must be a string literal.
+             * @return the next stage index, or -1 if the timeline is full.
+             */
+            static int32 next(int32 stage, const char* name);
+
+            /**
+             * Copies the stages.
+             *
+             * @param stages a buffer for stages.
+             * @param count  the maximum number of stages to copy.
+             * @return the number of stages copied.
+             */
+            static int32 read(Stage* stages, int32 count);
+
+        private:
+
+            /**
+             * The stages.
+             */
+            static Stage stages_[STAGES];
+
+            /**
+             * The number of stages.
+             */
+            static int32 length_;
+
+        };
+    }
+}
+#endif // SYSTEM_TIMELINE_HPP_
@@ -0,0 +1,116 @@
+/**
+ * Timeout of a blocking call.
+ *
+ * The timeout converts milliseconds to the kernel ticks once, and then
+ * tracks remaining ticks through any number of the kernel blocking calls.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_TIMEOUT_HPP_
+#define SYSTEM_TIMEOUT_HPP_
+
+#include "Types.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
+
+namespace local
+{
+    namespace system
+    {
+        class Timeout
+        {
+            typedef system::Timeout Self;
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * The timeout starts counting when it is constructed.
+             *
+             * @param millis a time to wait in milliseconds, a negative value is the same as zero.
+             */
+            explicit Timeout(int64 millis) :
+                state_ (),
+                ticks_ (toTicks(millis)){
+                vTaskSetTimeOutState(&state_);
+            }
+
+            /**
+             * Destructor.
+             */
+            ~Timeout()
+            {
+            }
+
+            /**
+             * Tests if the timeout has expired, and updates the remaining ticks.
+             *
+             * @return true if the timeout has expired.
+             */
+            bool isExpired()
+            {
+                return xTaskCheckForTimeOut(&state_, &ticks_) != pdFALSE;
+            }
+
+            /**
+             * Returns the remaining ticks calculated by the last test.
+             *
+             * @return the number of ticks to block.
+             */
+            TickType_t getTicks() const
+            {
+                return ticks_;
+            }
+
+            /**
+             * Converts milliseconds to the kernel ticks.
+             *
+             * The result is rounded up and never means an infinite wait.
+             *
+             * @param millis a time in milliseconds.
+             * @return the number of ticks.
+             */
+            static TickType_t toTicks(int64 millis)
+            {
+                if(millis <= 0) return 0;
+                uint64 const max = static_cast<uint64>(portMAX_DELAY) - 1;
+                // Limit milliseconds to prevent overflow of the multiplication below
+                uint64 const ms = static_cast<uint64>(millis) < max ? static_cast<uint64>(millis) : max;
+                uint64 const ticks = ( ms * configTICK_RATE_HZ + 999 ) / 1000;
+                return static_cast<TickType_t>( ticks < max ? ticks : max );
+            }
+
+        private:
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            Timeout(const Timeout& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            Timeout& operator =(const Timeout& obj);
+
+            /**
+             * The kernel time state when the timeout has started.
+             */
+            TimeOut_t state_;
+
+            /**
+             * The remaining ticks.
+             */
+            TickType_t ticks_;
+
+        };
+    }
+}
+#endif // SYSTEM_TIMEOUT_HPP_
@@ -0,0 +1,392 @@
+/**
+ * Kernel event tracer.
+ *
+ * The tracer writes compact time-stamped records of kernel and resource events
+ * to a ring buffer of each core. A writer reserves a record by one atomic addition,
+ * so threads and interrupt service routines write records without locks, and
+ * the oldest records are overwritten if a reader does not keep up with writers.
+ *
+ * A thread of the kernel events is identified by the address of its task control
+ * block. The operating system threads are not backed by kernel tasks yet, so they
+ * have their own creation and start events, which identify a thread by the address
+ * of its object. Objects are recorded by 64-bit fields, so addresses of 64-bit
+ * hosts are not truncated.
+ *
+ * The tracer records events only if EOOS_ENABLE_TRACE is defined, otherwise all
+ * its hooks are compiled to nothing. The ring buffer length is EOOS_TRACE_LENGTH
+ * records, which must be a power of two less than 65536.
+ *
+ * The kernel events are recorded by the trace hook functions, which are set to
+ * the kernel trace macros in FreeRTOSConfig.h as follows:
+ *
+ * void eoosTraceTaskSwitchedIn(void* task);
+ * void eoosTraceTaskSwitchedOut(void* task);
+ * void eoosTraceTaskCreate(void* task);
+ * void eoosTraceTaskDelete(void* task);
+ * void eoosTraceBlockingOnQueueReceive(void* queue);
+ * void eoosTraceBlockingOnQueueSend(void* queue);
+ *
+ * #define traceTASK_SWITCHED_IN()                eoosTraceTaskSwitchedIn(pxCurrentTCB)
+ * #define traceTASK_SWITCHED_OUT()               eoosTraceTaskSwitchedOut(pxCurrentTCB)
+ * #define traceTASK_CREATE(pxNewTCB)             eoosTraceTaskCreate(pxNewTCB)
+ * #define traceTASK_DELETE(pxTaskToDelete)       eoosTraceTaskDelete(pxTaskToDelete)
+ * #define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) eoosTraceBlockingOnQueueReceive(pxQueue)
+ * #define traceBLOCKING_ON_QUEUE_SEND(pxQueue)    eoosTraceBlockingOnQueueSend(pxQueue)
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_TRACE_HPP_
+#define SYSTEM_TRACE_HPP_
+
+#include "Types.hpp"
+#include "system.Atomic.hpp"
+#include "system.Clock.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifndef EOOS_TRACE_LENGTH
+#define EOOS_TRACE_LENGTH 1024
+#endif
+
+namespace local
+{
+    namespace system
+    {
+        class Trace
+        {
+            typedef system::Trace Self;
+
+        public:
+
+            /**
+             * Traced events.
+             */
+            enum Event
+            {
+                THREAD_SWITCH_IN     = 1,
+                THREAD_SWITCH_OUT    = 2,
+                THREAD_CREATE        = 3,
+                THREAD_DELETE        = 4,
+                THREAD_START         = 5,
+                QUEUE_RECEIVE_BLOCK  = 6,
+                QUEUE_SEND_BLOCK     = 7,
+                INTERRUPT_ENTER      = 8,
+                INTERRUPT_EXIT       = 9,
+                MUTEX_WAIT           = 10,
+                MUTEX_LOCK           = 11,
+                MUTEX_UNLOCK         = 12,
+                SEMAPHORE_WAIT       = 13,
+                SEMAPHORE_ACQUIRE    = 14,
+                SEMAPHORE_RELEASE    = 15,
+                THREAD_OBJECT_CREATE = 16
+            };
+
+            /**
+             * A trace record.
+             */
+            struct Record
+            {
+                /**
+                 * The event time in nanoseconds.
+                 */
+                int64 time;
+
+                /**
+                 * The event object, which is an address of a thread or a resource, or an interrupt source.
+                 */
+                uint64 object;
+
+                /**
+                 * The event.
+                 */
+                uint16 event;
+
+                /**
+                 * The core the event has happened on.
+                 */
+                uint16 core;
+            };
+
+            /**
+             * The number of cores.
+             */
+            #if defined(configNUMBER_OF_CORES) && configNUMBER_OF_CORES > 1
+            static const int32 CORES = configNUMBER_OF_CORES;
+            #else
+            static const int32 CORES = 1;
+            #endif
+
+            /**
+             * Records an event of an object.
+             *
+             * @param event  an event.
+             * @param object an object address.
+             */
+            static void record(Event event, const void* object)
+            {
+                #ifdef EOOS_ENABLE_TRACE
+                write(event, static_cast<uint64>( reinterpret_cast<size_t>(object) ));
+                #else
+                static_cast<void>(event);
+                static_cast<void>(object);
+                #endif
+            }
+
+            /**
+             * Records an event of a numbered object.
+             *
+             * @param event  an event.
+             * @param number an object number.
+             */
+            static void record(Event event, int32 number)
+            {
+                #ifdef EOOS_ENABLE_TRACE
+                write(event, static_cast<uint64>( static_cast<uint32>(number) ));
+                #else
+                static_cast<void>(event);
+                static_cast<void>(number);
+                #endif
+            }
+
+            /**
+             * Makes a reader the only reader of the records.
+             *
+             * @param reader a reader.
+             * @return true if the reader has been attached, or false if another one is attached.
+             */
+            static bool attach(const void* reader);
+
+            /**
+             * Lets another reader be attached.
+             *
+             * @param reader the attached reader.
+             */
+            static void detach(const void* reader);
+
+            /**
+             * Reads records of a core, which have not been read yet.
+             *
+             * The method keeps the read position of each core without synchronization,
+             * so it reads nothing for a reader which is not attached.
+             *
+             * @param reader  the attached reader.
+             * @param core    a core number.
+             * @param records an array for the records.
+             * @param count   the array length.
+             * @return the number of read records.
+             */
+            static int32 read(const void* reader, int32 core, Record* records, int32 count);
+
+            /**
+             * Returns the number of records of a core, which have been overwritten before reading.
+             *
+             * @param core a core number.
+             * @return the number of lost records.
+             */
+            static int64 getLost(int32 core);
+
+        private:
+
+            #ifdef EOOS_ENABLE_TRACE
+
+            /**
+             * The ring buffer length.
+             */
+            static const uint32 LENGTH = EOOS_TRACE_LENGTH;
+
+            /**
+             * The compilation fails if the length is not a power of two less than 65536.
+             */
+            typedef char LengthIsValid[ ( LENGTH < 65536 && (LENGTH & (LENGTH - 1)) == 0 ) ? 1 : -1 ];
+
+            /**
+             * A record of a ring buffer.
+             */
+            struct Slot
+            {
+                /**
+                 * Constructor.
+                 */
+                Slot() :
+                    time     (0),
+                    object   (0),
+                    event    (0),
+                    sequence (0){
+                }
+
+                /**
+                 * The event time in nanoseconds.
+                 */
+                int64 time;
+
+                /**
+                 * The event object.
+                 */
+                uint64 object;
+
+                /**
+                 * The event.
+                 */
+                uint16 event;
+
+                /**
+                 * The low bits of the record position plus one, which are set when the record is written.
+                 */
+                Atomic<uint16> sequence;
+            };
+
+            /**
+             * A ring buffer of a core.
+             */
+            struct Ring
+            {
+                /**
+                 * Constructor.
+                 */
+                Ring() :
+                    head (0),
+                    tail (0),
+                    lost (0){
+                }
+
+                /**
+                 * The position of the next record to write.
+                 */
+                Atomic<uint32> head;
+
+                /**
+                 * The position of the next record to read.
+                 */
+                uint32 tail;
+
+                /**
+                 * The number of records overwritten before reading.
+                 */
+                int64 lost;
+
+                /**
+                 * The records.
+                 */
+                Slot slots[LENGTH];
+            };
+
+            /**
+             * Writes a record to the ring buffer of the current core.
+             *
+             * @param event  an event.
+             * @param object an object.
+             */
+            static void write(Event event, uint64 object)
+            {
+                Ring& ring = rings_[getCore()];
+                uint32 const index = ring.head.add(1);
+                Slot& slot = ring.slots[index & (LENGTH - 1)];
+                // Invalidate the record for readers before changing it
+                slot.sequence.store( static_cast<uint16>(index) );
+                slot.time = Clock::getTime();
+                slot.object = object;
+                slot.event = static_cast<uint16>(event);
+                slot.sequence.store( static_cast<uint16>(index + 1) );
+            }
+
+            /**
+             * Returns the current core.
+             *
+             * @return the core number.
+             */
+            static int32 getCore()
+            {
+                #if defined(configNUMBER_OF_CORES) && configNUMBER_OF_CORES > 1
+                return static_cast<int32>( portGET_CORE_ID() );
+                #else
+                return 0;
+                #endif
+            }
+
+            /**
+             * The ring buffers of the cores.
+             */
+            static Ring rings_[CORES];
+
+            #endif // EOOS_ENABLE_TRACE
+
+            /**
+             * The attached reader, or NULL if the records have no reader.
+             */
+            static Atomic<const void*> reader_;
+
+            /**
+             * Constructor.
+             */
+            Trace();
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            Trace(const Trace& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            Trace& operator =(const Trace& obj);
+
+        };
+    }
+}
+
+#ifdef EOOS_ENABLE_TRACE
+
+extern "C"
+{
+    /**
+     * Records a switch to a kernel task.
+     *
+     * @param task the task control block.
+     */
+    void eoosTraceTaskSwitchedIn(void* task);
+
+    /**
+     * Records a switch from a kernel task.
+     *
+     * @param task the task control block.
+     */
+    void eoosTraceTaskSwitchedOut(void* task);
+
+    /**
+     * Records a creation of a kernel task.
+     *
+     * @param task the task control block.
+     */
+    void eoosTraceTaskCreate(void* task);
+
+    /**
+     * Records a deletion of a kernel task.
+     *
+     * @param task the task control block.
+     */
+    void eoosTraceTaskDelete(void* task);
+
+    /**
+     * Records blocking of a task on receiving from a kernel queue or semaphore.
+     *
+     * @param queue the kernel queue.
+     */
+    void eoosTraceBlockingOnQueueReceive(void* queue);
+
+    /**
+     * Records blocking of a task on sending to a kernel queue or semaphore.
+     *
+     * @param queue the kernel queue.
+     */
+    void eoosTraceBlockingOnQueueSend(void* queue);
+}
+
+#endif // EOOS_ENABLE_TRACE
+#endif // SYSTEM_TRACE_HPP_
@@ -0,0 +1,200 @@
+/**
+ * Trace exporter class.
+ *
+ * The exporter streams kernel trace records to a byte sink in the Common Trace
+ * Format 1.8. A thread of the lowest priority above the idle one drains the trace
+ * buffers periodically, and writes a packet of records of each core, so draining
+ * never stops the scheduler, and only takes idle time. The metadata of the stream
+ * is a separate text, which a viewer reads from a file named 'metadata' put near
+ * the stream file. The trace records have one reader, so the construction of an
+ * exporter fails while another exporter exists.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_TRACE_EXPORTER_HPP_
+#define SYSTEM_TRACE_EXPORTER_HPP_
+
+#include "system.Object.hpp"
+#include "api.Resource.hpp"
+#include "system.Atomic.hpp"
+#include "system.Trace.hpp"
+#include "system.TraceSink.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
+
+namespace local
+{
+    namespace system
+    {
+        class TraceExporter : public system::Object, public api::Resource
+        {
+            typedef system::TraceExporter Self;
+            typedef system::Object        Parent;
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param sink   a sink of the stream.
+             * @param period a period of draining in milliseconds.
+             */
+            TraceExporter(TraceSink& sink, int64 period);
+
+            /**
+             * Destructor.
+             *
+             * The destructor drains the rest of records, and stops the thread.
+             */
+            virtual ~TraceExporter();
+
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            virtual bool isConstructed() const;
+
+            /**
+             * Tests if this resource is blocked.
+             *
+             * @return true if the sink has failed.
+             */
+            virtual bool isBlocked() const;
+
+            /**
+             * Writes the metadata of the stream.
+             *
+             * @param sink a sink of the metadata.
+             * @return true if the metadata has been written.
+             */
+            static bool writeMetadata(TraceSink& sink);
+
+        private:
+
+            /**
+             * The maximum number of records of a packet.
+             */
+            static const int32 RECORDS = 64;
+
+            /**
+             * The size of a packet header and a packet context in bytes.
+             */
+            static const int32 HEADER_SIZE = 44;
+
+            /**
+             * The size of an event in bytes.
+             */
+            static const int32 EVENT_SIZE = 18;
+
+            /**
+             * The stack size of the thread in words.
+             */
+            static const uint16 STACK_SIZE = configMINIMAL_STACK_SIZE * 2;
+
+            /**
+             * Constructor.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            bool construct();
+
+            /**
+             * Drains the trace buffers to the sink.
+             *
+             * @return true if the sink has written all the packets.
+             */
+            bool drain();
+
+            /**
+             * Writes a packet of records of a core to the sink.
+             *
+             * @param core  a core number.
+             * @param count the number of records.
+             * @return true if the sink has written the packet.
+             */
+            bool send(int32 core, int32 count);
+
+            /**
+             * Drains the trace buffers periodically.
+             *
+             * @param argument the exporter.
+             */
+            static void main(void* argument);
+
+            /**
+             * Puts an integer to a buffer in the little-endian byte order.
+             *
+             * @param buf   a buffer.
+             * @param value a value.
+             * @param size  the value size in bytes.
+             * @return the buffer address next to the value.
+             */
+            static uint8* put(uint8* buf, uint64 value, int32 size);
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            TraceExporter(const TraceExporter& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            TraceExporter& operator =(const TraceExporter& obj);
+
+            /**
+             * The sink of the stream.
+             */
+            TraceSink& sink_;
+
+            /**
+             * The period of draining in ticks.
+             */
+            TickType_t period_;
+
+            /**
+             * The thread.
+             */
+            TaskHandle_t task_;
+
+            /**
+             * The exporter is the reader of the trace records.
+             */
+            bool isAttached_;
+
+            /**
+             * The thread is requested to stop.
+             */
+            Atomic<bool> isStopping_;
+
+            /**
+             * The thread has stopped.
+             */
+            Atomic<bool> isStopped_;
+
+            /**
+             * The sink has failed.
+             */
+            Atomic<bool> isFailed_;
+
+            /**
+             * The records of a packet.
+             */
+            Trace::Record records_[RECORDS];
+
+            /**
+             * The packet.
+             */
+            uint8 packet_[HEADER_SIZE + RECORDS * EVENT_SIZE];
+
+        };
+    }
+}
+#endif // SYSTEM_TRACE_EXPORTER_HPP_
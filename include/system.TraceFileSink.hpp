@@ -0,0 +1,130 @@
+/**
+ * File sink of trace data.
+ *
+ * The sink writes trace data to a file or a named pipe of a POSIX host,
+ * so it is available only if EOOS_PORT_POSIX is defined. A write interrupted
+ * by a signal, which is also an interrupt source of the port, is retried.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_TRACE_FILE_SINK_HPP_
+#define SYSTEM_TRACE_FILE_SINK_HPP_
+
+#ifdef EOOS_PORT_POSIX
+
+#include "system.Object.hpp"
+#include "system.TraceSink.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+namespace local
+{
+    namespace system
+    {
+        class TraceFileSink : public system::Object, public system::TraceSink
+        {
+            typedef system::TraceFileSink Self;
+            typedef system::Object        Parent;
+
+        public:
+
+            /**
+             * Constructor.
+             *
+             * @param path a path to a file or a named pipe, which is created or truncated.
+             */
+            explicit TraceFileSink(const char* path) : Parent(),
+                file_ (-1){
+                bool const isConstructed = construct(path);
+                setConstructed( isConstructed );
+            }
+
+            /**
+             * Destructor.
+             */
+            virtual ~TraceFileSink()
+            {
+                if(file_ >= 0)
+                {
+                    static_cast<void>( ::close(file_) );
+                }
+            }
+
+            /**
+             * Tests if this object has been constructed.
+             *
+             * @return true if object has been constructed successfully.
+             */
+            virtual bool isConstructed() const
+            {
+                return Parent::isConstructed();
+            }
+
+            /**
+             * Writes bytes to the file.
+             *
+             * @param data an address of bytes.
+             * @param size the number of bytes.
+             * @return true if all the bytes have been written.
+             */
+            virtual bool write(const void* const data, size_t const size)
+            {
+                if( not Self::isConstructed() ) return false;
+                const uint8* bytes = static_cast<const uint8*>(data);
+                size_t left = size;
+                while(left > 0)
+                {
+                    ssize_t const written = ::write(file_, bytes, left);
+                    if(written < 0 && errno == EINTR) continue;
+                    if(written <= 0) return false;
+                    bytes += written;
+                    left -= static_cast<size_t>(written);
+                }
+                return true;
+            }
+
+        private:
+
+            /**
+             * Constructor.
+             *
+             * @param path a path to a file or a named pipe.
+             * @return true if object has been constructed successfully.
+             */
+            bool construct(const char* const path)
+            {
+                if( not Self::isConstructed() ) return false;
+                if(path == NULL) return false;
+                file_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                return file_ >= 0;
+            }
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            TraceFileSink(const TraceFileSink& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            TraceFileSink& operator =(const TraceFileSink& obj);
+
+            /**
+             * The file descriptor.
+             */
+            int file_;
+
+        };
+    }
+}
+
+#endif // EOOS_PORT_POSIX
+#endif // SYSTEM_TRACE_FILE_SINK_HPP_
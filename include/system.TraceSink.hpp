@@ -0,0 +1,44 @@
+/**
+ * Byte sink of trace data.
+ *
+ * A sink passes exported trace data out of the target, for example to a UART,
+ * a file or a pipe. A user implements the interface for a transport of the target.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_TRACE_SINK_HPP_
+#define SYSTEM_TRACE_SINK_HPP_
+
+#include "Types.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        class TraceSink
+        {
+
+        public:
+
+            /**
+             * Destructor.
+             */
+            virtual ~TraceSink()
+            {
+            }
+
+            /**
+             * Writes bytes to the sink.
+             *
+             * @param data an address of bytes.
+             * @param size the number of bytes.
+             * @return true if all the bytes have been written.
+             */
+            virtual bool write(const void* data, size_t size) = 0;
+
+        };
+    }
+}
+#endif // SYSTEM_TRACE_SINK_HPP_
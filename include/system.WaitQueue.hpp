@@ -0,0 +1,290 @@
+/**
+ * Queue of threads waiting for a resource.
+ *
+ * The queue does not allocate memory and does not create kernel objects.
+ * Each waiting thread puts its own record allocated on its stack to the queue,
+ * and sleeps on the notification of its kernel task. All the modifications
+ * of the queue must be executed with disabled interrupts by the queue owner.
+ *
+ * The threads sleep on the notification index EOOS_NOTIFICATION_INDEX, which
+ * is reserved for the operating system, so the notifications of the default
+ * index, which programs send to the threads, are neither taken nor faked.
+ * A notification which comes after the timeout of its waiter is left pending
+ * on the reserved index, and the next wait of the thread only tests its own
+ * record once more.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef SYSTEM_WAIT_QUEUE_HPP_
+#define SYSTEM_WAIT_QUEUE_HPP_
+
+#include "Types.hpp"
+#include "system.Timeout.hpp"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#ifndef EOOS_NOTIFICATION_INDEX
+#define EOOS_NOTIFICATION_INDEX 1
+#endif
+
+namespace local
+{
+    namespace system
+    {
+        class WaitQueue
+        {
+            typedef system::WaitQueue Self;
+
+            /**
+             * The compilation fails if the kernel has no reserved notification index.
+             */
+            typedef char IndexIsReserved[ ( EOOS_NOTIFICATION_INDEX > 0 && EOOS_NOTIFICATION_INDEX < configTASK_NOTIFICATION_ARRAY_ENTRIES ) ? 1 : -1 ];
+
+        public:
+
+            /**
+             * The notification index of the waiting threads.
+             */
+            static const UBaseType_t INDEX = EOOS_NOTIFICATION_INDEX;
+
+            /**
+             * A record of a waiting thread.
+             */
+            struct Waiter
+            {
+                /**
+                 * Constructor.
+                 *
+                 * @param req a value requested by the thread.
+                 */
+                explicit Waiter(int32 req) :
+                    task       (xTaskGetCurrentTaskHandle()),
+                    priority   (uxTaskPriorityGet(NULL)),
+                    request    (req),
+                    isSignaled (false),
+                    next       (NULL){
+                }
+
+                /**
+                 * The kernel task of the thread.
+                 */
+                TaskHandle_t task;
+
+                /**
+                 * The priority of the thread when it has started waiting.
+                 */
+                UBaseType_t priority;
+
+                /**
+                 * A value requested by the thread.
+                 */
+                int32 request;
+
+                /**
+                 * The thread has been released from the queue.
+                 */
+                volatile bool isSignaled;
+
+                /**
+                 * Next waiting thread.
+                 */
+                Waiter* next;
+            };
+
+            /**
+             * Constructor.
+             *
+             * @param isFifo true if threads are queued in arrival order,
+             *               or false if higher priority threads go first.
+             */
+            explicit WaitQueue(bool isFifo) :
+                head_   (NULL),
+                isFifo_ (isFifo){
+            }
+
+            /**
+             * Destructor.
+             */
+            ~WaitQueue()
+            {
+            }
+
+            /**
+             * Tests if the queue is empty.
+             *
+             * @return true if no threads wait.
+             */
+            bool isEmpty() const
+            {
+                return head_ == NULL;
+            }
+
+            /**
+             * Returns the first waiting thread.
+             *
+             * @return the first thread record, or NULL if the queue is empty.
+             */
+            Waiter* getFirst() const
+            {
+                return head_;
+            }
+
+            /**
+             * Adds a thread to the queue.
+             *
+             * @param waiter the thread record.
+             */
+            void add(Waiter& waiter)
+            {
+                Waiter** link = &head_;
+                while(*link != NULL)
+                {
+                    // Threads of the same priority are always queued in arrival order
+                    if( not isFifo_ && (*link)->priority < waiter.priority ) break;
+                    link = &(*link)->next;
+                }
+                waiter.next = *link;
+                *link = &waiter;
+            }
+
+            /**
+             * Removes a thread from the queue.
+             *
+             * @param waiter the thread record.
+             * @return true if the thread has been in the queue.
+             */
+            bool remove(Waiter& waiter)
+            {
+                Waiter** link = &head_;
+                while(*link != NULL)
+                {
+                    if(*link == &waiter)
+                    {
+                        *link = waiter.next;
+                        waiter.next = NULL;
+                        return true;
+                    }
+                    link = &(*link)->next;
+                }
+                return false;
+            }
+
+            /**
+             * Removes the first thread from the queue and wakes it up.
+             */
+            void signalFirst()
+            {
+                Waiter* const waiter = head_;
+                if(waiter != NULL)
+                {
+                    head_ = waiter->next;
+                    waiter->next = NULL;
+                    waiter->isSignaled = true;
+                    static_cast<void>( xTaskNotifyGiveIndexed(waiter->task, INDEX) );
+                }
+            }
+
+            /**
+             * Removes the first thread from the queue and wakes it up from an interrupt service routine.
+             *
+             * @param isWoken set to pdTRUE if a woken thread has higher priority than an interrupted one.
+             */
+            void signalFirstFromInterrupt(BaseType_t* isWoken)
+            {
+                Waiter* const waiter = head_;
+                if(waiter != NULL)
+                {
+                    head_ = waiter->next;
+                    waiter->next = NULL;
+                    waiter->isSignaled = true;
+                    vTaskNotifyGiveIndexedFromISR(waiter->task, INDEX, isWoken);
+                }
+            }
+
+            /**
+             * Removes the first thread from the queue and wakes it up from a thread or an interrupt service routine.
+             *
+             * @param isWoken NULL if the caller is a thread, or a flag of an interrupt service routine,
+             *                which is set to pdTRUE if a woken thread has higher priority than an interrupted one.
+             */
+            void signalFirst(BaseType_t* isWoken)
+            {
+                if(isWoken == NULL)
+                {
+                    signalFirst();
+                }
+                else
+                {
+                    signalFirstFromInterrupt(isWoken);
+                }
+            }
+
+            /**
+             * Sleeps until the caller thread record is signaled.
+             *
+             * The method must be called with enabled interrupts.
+             *
+             * @param waiter the caller thread record.
+             */
+            static void wait(Waiter& waiter)
+            {
+                while( not waiter.isSignaled )
+                {
+                    static_cast<void>( ulTaskNotifyTakeIndexed(INDEX, pdTRUE, portMAX_DELAY) );
+                }
+            }
+            
+            /**
+             * Sleeps until the caller thread record is signaled or a timeout expires.
+             *
+             * The method must be called with enabled interrupts. If the timeout has 
+             * expired, the caller must remove its record from the queue, and test
+             * the record again, as it might be signaled before the removal.
+             *
+             * @param waiter  the caller thread record.
+             * @param timeout the timeout.
+             * @return true if the record has been signaled.
+             */
+            static bool wait(Waiter& waiter, Timeout& timeout)
+            {
+                while( not waiter.isSignaled )
+                {
+                    if( timeout.isExpired() ) return false;
+                    static_cast<void>( ulTaskNotifyTakeIndexed(INDEX, pdTRUE, timeout.getTicks()) );
+                }
+                return true;
+            }
+
+        private:
+
+            /**
+             * Copy constructor.
+             *
+             * @param obj reference to source object.
+             */
+            WaitQueue(const WaitQueue& obj);
+
+            /**
+             * Assignment operator.
+             *
+             * @param obj reference to source object.
+             * @return reference to this object.
+             */
+            WaitQueue& operator =(const WaitQueue& obj);
+
+            /**
+             * The first waiting thread.
+             */
+            Waiter* head_;
+
+            /**
+             * The queue order.
+             */
+            bool isFifo_;
+
+        };
+    }
+}
+#endif // SYSTEM_WAIT_QUEUE_HPP_
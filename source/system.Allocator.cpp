@@ -6,11 +6,25 @@
  * @license   http://embedded.team/license/
  */
 #include "system.Allocator.hpp"
+#include "FreeRTOS.h"
+#ifdef EOOS_ENABLE_STATIC_MEMORY
+#include "system.StaticMemory.hpp"
+#include "system.MemoryLayout.hpp"
+#endif // EOOS_ENABLE_STATIC_MEMORY
 
 namespace local
 {
     namespace system
     {
+        #ifdef EOOS_ENABLE_STATIC_MEMORY
+    
+        /**
+         * The static memory of the operating system.
+         */
+        typedef StaticMemory<MemoryLayout> Memory;
+        
+        #endif // EOOS_ENABLE_STATIC_MEMORY
+    
         /**
          * Allocates memory.
          *
@@ -19,7 +33,11 @@ namespace local
          */    
         void* Allocator::allocate(size_t const size)
         {
-            return NULL;
+            #ifdef EOOS_ENABLE_STATIC_MEMORY
+            return Memory::allocate(size);
+            #else
+            return pvPortMalloc(size);
+            #endif // EOOS_ENABLE_STATIC_MEMORY
         }
         
         /**
@@ -29,7 +47,40 @@ namespace local
          */      
         void Allocator::free(void* const ptr)
         {
+            if(ptr == NULL) return;
+            #ifdef EOOS_ENABLE_STATIC_MEMORY
+            Memory::free(ptr);
+            #else
+            vPortFree(ptr);
+            #endif // EOOS_ENABLE_STATIC_MEMORY
         }
         
     }
 }
+
+#ifdef EOOS_ENABLE_STATIC_MEMORY
+
+/**
+ * Allocates memory of the kernel.
+ *
+ * The kernel takes the static memory, so the image is linked without a kernel heap.
+ *
+ * @param size - number of bytes to allocate.
+ * @return allocated memory address or a null pointer.
+ */
+void* pvPortMalloc(size_t size)
+{
+    return ::local::system::Allocator::allocate(size);
+}
+
+/**
+ * Frees memory of the kernel.
+ *
+ * @param ptr address of allocated memory block or a null pointer.
+ */
+void vPortFree(void* ptr)
+{
+    ::local::system::Allocator::free(ptr);
+}
+
+#endif // EOOS_ENABLE_STATIC_MEMORY
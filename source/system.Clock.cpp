@@ -0,0 +1,208 @@
+/**
+ * Monotonic system clock.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#ifndef EOOS_PORT_POSIX
+// The kernel configuration is tested before the kernel defines its empty trace macros
+#include "FreeRTOSConfig.h"
+#ifndef traceTASK_INCREMENT_TICK
+#error "The kernel tick must refresh the clock by traceTASK_INCREMENT_TICK calling eoosClockTick"
+#endif
+#endif // EOOS_PORT_POSIX
+#include "system.Clock.hpp"
+#ifdef EOOS_PORT_POSIX
+#include <time.h>
+#endif
+#if defined(EOOS_PORT_CORTEX_M) && ( defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_8M_BASE__) )
+#error "The core has no DWT cycle counter, which the clock of EOOS_PORT_CORTEX_M needs"
+#endif
+
+namespace local
+{
+    namespace system
+    {
+        #ifdef EOOS_PORT_CORTEX_M
+
+        /**
+         * The debug exception and monitor control register.
+         */
+        static volatile uint32& DEMCR = *reinterpret_cast<volatile uint32*>(0xE000EDFC);
+
+        /**
+         * The trace enable bit of the debug exception and monitor control register.
+         */
+        static const uint32 DEMCR_TRCENA = 0x01000000;
+
+        /**
+         * The DWT control register.
+         */
+        static volatile uint32& DWT_CTRL = *reinterpret_cast<volatile uint32*>(0xE0001000);
+
+        /**
+         * The cycle counter enable bit of the DWT control register.
+         */
+        static const uint32 DWT_CTRL_CYCCNTENA = 0x00000001;
+
+        /**
+         * The DWT cycle count register.
+         */
+        static volatile uint32& DWT_CYCCNT = *reinterpret_cast<volatile uint32*>(0xE0001004);
+
+        /**
+         * The CPU cycle period in nanoseconds in the 32.32 fixed-point format.
+         */
+        static const uint64 NS_PER_CYCLE_Q32 = (static_cast<uint64>(1000000000) << 32) / configCPU_CLOCK_HZ;
+
+        #endif // EOOS_PORT_CORTEX_M
+
+        /**
+         * Returns the time since the clock start.
+         *
+         * @return time in nanoseconds.
+         */
+        int64 Clock::getTime()
+        {
+            #if defined(EOOS_PORT_POSIX) || defined(EOOS_PORT_CORTEX_M)
+            int64 const time = getCounterTime();
+            // The first reading is not concurrent, as it is done by the construction of the operating system
+            if( not isStarted_ )
+            {
+                base_ = time;
+                isStarted_ = true;
+            }
+            return time - base_;
+            #else
+            return static_cast<int64>( getTicks() ) * NS_PER_TICK;
+            #endif
+        }
+
+        /**
+         * Refreshes the extension of the counter on a kernel tick.
+         */
+        void Clock::tick()
+        {
+            #if defined(EOOS_PORT_CORTEX_M)
+            static_cast<void>( getCounterTime() );
+            #elif defined(EOOS_PORT_POSIX)
+            // The host clock is not extended
+            #else
+            static_cast<void>( getTicks() );
+            #endif
+        }
+
+        #if defined(EOOS_PORT_POSIX)
+
+        /**
+         * Returns the time of the counter.
+         *
+         * @return time in nanoseconds.
+         */
+        int64 Clock::getCounterTime()
+        {
+            // The host clock is finer than the simulated ticks, so it is used alone
+            struct ::timespec now;
+            static_cast<void>( ::clock_gettime(CLOCK_MONOTONIC, &now) );
+            return static_cast<int64>(now.tv_sec) * 1000000000 + static_cast<int64>(now.tv_nsec);
+        }
+
+        #elif defined(EOOS_PORT_CORTEX_M)
+
+        /**
+         * Returns the time of the counter.
+         *
+         * @return time in nanoseconds.
+         */
+        int64 Clock::getCounterTime()
+        {
+            if( (DWT_CTRL & DWT_CTRL_CYCCNTENA) == 0 )
+            {
+                DEMCR |= DEMCR_TRCENA;
+                DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+            }
+            uint32 const high = cycles_.load();
+            uint64 const cycles = extend(cycles_, high, DWT_CYCCNT);
+            // The product is taken by 32-bit halves, as it does not fit 64 bits
+            uint64 const cyclesHigh = cycles >> 32;
+            uint64 const cyclesLow = cycles & 0xFFFFFFFF;
+            uint64 const rateHigh = NS_PER_CYCLE_Q32 >> 32;
+            uint64 const rateLow = NS_PER_CYCLE_Q32 & 0xFFFFFFFF;
+            uint64 const time = ( (cyclesHigh * rateHigh) << 32 ) + cyclesHigh * rateLow + cyclesLow * rateHigh + ( (cyclesLow * rateLow) >> 32 );
+            return static_cast<int64>(time);
+        }
+
+        #endif
+
+        /**
+         * Returns the tick count extended to 63 bits.
+         *
+         * @return the number of ticks since the kernel start.
+         */
+        uint64 Clock::getTicks()
+        {
+            uint32 const high = high_.load();
+            // The ISR version of the call is valid in both contexts, and takes no critical section for 32-bit ticks
+            uint32 const low = static_cast<uint32>( xTaskGetTickCountFromISR() );
+            return extend(high_, high, low);
+        }
+
+        /**
+         * Extends a 32-bit counter to 63 bits.
+         *
+         * The high word must be read before the low one, as a preempting reader
+         * might extend the high word with a low word which has already wrapped.
+         *
+         * @param word the high word of the counter, and the high bit of its last read low word.
+         * @param high the read value of the high word.
+         * @param low  the low word of the counter, which has been read after the high word.
+         * @return the extended counter.
+         */
+        uint64 Clock::extend(Atomic<uint32>& word, uint32 high, uint32 const low)
+        {
+            if( ( (high ^ low) & 0x80000000 ) != 0 )
+            {
+                // The low word has crossed its half, so the high bit is toggled,
+                // and the high word is incremented if the low word has wrapped
+                uint32 const next = (high ^ 0x80000000) + (high >> 31);
+                // Another reader might have extended the high word meanwhile
+                static_cast<void>( word.compareAndSwap(high, next) );
+                high = next;
+            }
+            return ( static_cast<uint64>(high & 0x7FFFFFFF) << 32 ) | low;
+        }
+
+        /**
+         * The high word of the tick count, and the high bit of its last read low word.
+         */
+        Atomic<uint32> Clock::high_(0);
+
+        #ifdef EOOS_PORT_CORTEX_M
+
+        /**
+         * The high word of the cycle count, and the high bit of its last read low word.
+         */
+        Atomic<uint32> Clock::cycles_(0);
+
+        #endif // EOOS_PORT_CORTEX_M
+
+        /**
+         * The time of the counter at the clock start.
+         */
+        int64 Clock::base_ = 0;
+
+        /**
+         * The clock has been started.
+         */
+        bool Clock::isStarted_ = false;
+    }
+}
+
+/**
+ * Refreshes the clock on a kernel tick.
+ */
+void eoosClockTick(void)
+{
+    local::system::Clock::tick();
+}
@@ -0,0 +1,255 @@
+/**
+ * Deferred interrupt resource.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.DeferredInterrupt.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Constructor.
+         *
+         * @param handler user class which implements an interrupt handler interface.
+         * @param source  available interrupt source.
+         */
+        DeferredInterrupt::DeferredInterrupt(api::Task& handler, int32 const source) : Parent(),
+            handler_      (handler),
+            acknowledger_ (*this),
+            interrupt_    (acknowledger_, source),
+            bit_          (0),
+            isEnabled_    (false),
+            isMasked_     (false){
+            bool const isConstructed = construct();
+            setConstructed( isConstructed );
+        }
+
+        /**
+         * Destructor.
+         */
+        DeferredInterrupt::~DeferredInterrupt()
+        {
+            if(bit_ == 0) return;
+            static_cast<void>( interrupt_.disable() );
+            bool const is = system::Interrupt::disableAll();
+            for(int32 i=0; i<SLOTS; i++)
+            {
+                if(slots_[i] == this)
+                {
+                    slots_[i] = NULL;
+                    break;
+                }
+            }
+            // A trigger, which has not been taken by the daemon thread, must not execute a next resource of the bit
+            static_cast<void>( ulTaskNotifyValueClear(daemon_, bit_) );
+            system::Interrupt::enableAll(is);
+            if( xTaskGetCurrentTaskHandle() == daemon_ )
+            {
+                // The handler deletes its own resource, so the daemon thread must not use it on return
+                if(current_ == this)
+                {
+                    current_ = NULL;
+                }
+            }
+            else
+            {
+                // Wait for the handler, as the daemon thread might have taken it before the removal
+                while(current_ == this)
+                {
+                    vTaskDelay(1);
+                }
+            }
+        }
+
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool DeferredInterrupt::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+
+        /**
+         * Jumps to interrupt hardware vector.
+         */
+        void DeferredInterrupt::jump()
+        {
+            if( not Self::isConstructed() ) return;
+            interrupt_.jump();
+        }
+
+        /**
+         * Clears an interrupt status of this source.
+         */
+        void DeferredInterrupt::clear()
+        {
+            if( not Self::isConstructed() ) return;
+            interrupt_.clear();
+        }
+
+        /**
+         * Sets an interrupt status of this source.
+         */
+        void DeferredInterrupt::set()
+        {
+            if( not Self::isConstructed() ) return;
+            interrupt_.set();
+        }
+
+        /**
+         * Locks this interrupt source.
+         *
+         * @return an interrupt enable source bit value before method was called.
+         */
+        bool DeferredInterrupt::disable()
+        {
+            if( not Self::isConstructed() ) return false;
+            bool const is = system::Interrupt::disableAll();
+            bool const status = isEnabled_;
+            isEnabled_ = false;
+            static_cast<void>( interrupt_.disable() );
+            system::Interrupt::enableAll(is);
+            return status;
+        }
+
+        /**
+         * Unlocks this interrupt source.
+         *
+         * @param status returned status by lock method.
+         */
+        void DeferredInterrupt::enable(bool const status)
+        {
+            if( not Self::isConstructed() ) return;
+            if( not status ) return;
+            bool const is = system::Interrupt::disableAll();
+            isEnabled_ = true;
+            bool const isMasked = isMasked_;
+            system::Interrupt::enableAll(is);
+            // The daemon thread enables the source disabled by the interrupt service routine
+            if( not isMasked )
+            {
+                interrupt_.enable(true);
+            }
+        }
+
+        /**
+         * Requests the handler execution from a thread.
+         */
+        void DeferredInterrupt::raise()
+        {
+            if(bit_ == 0) return;
+            static_cast<void>( xTaskNotify(daemon_, bit_, eSetBits) );
+        }
+
+        /**
+         * Requests the handler execution from an interrupt service routine.
+         */
+        void DeferredInterrupt::raiseFromInterrupt()
+        {
+            if(bit_ == 0) return;
+            BaseType_t isWoken = pdFALSE;
+            static_cast<void>( xTaskNotifyFromISR(daemon_, bit_, eSetBits, &isWoken) );
+            portYIELD_FROM_ISR(isWoken);
+        }
+
+        /**
+         * Constructor.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool DeferredInterrupt::construct()
+        {
+            if( not Self::isConstructed() ) return false;
+            if( not acknowledger_.isConstructed() ) return false;
+            if( not interrupt_.isConstructed() ) return false;
+            // The daemon thread is created by the first resource, and is never deleted
+            if(daemon_ == NULL)
+            {
+                TaskHandle_t daemon = NULL;
+                if( xTaskCreate(&main, "DEFERRED", STACK_SIZE, NULL, configMAX_PRIORITIES - 1, &daemon) != pdPASS ) return false;
+                bool const is = system::Interrupt::disableAll();
+                bool const isCreated = daemon_ != NULL;
+                if( not isCreated )
+                {
+                    daemon_ = daemon;
+                }
+                system::Interrupt::enableAll(is);
+                // Another resource might have created the daemon thread meanwhile
+                if(isCreated)
+                {
+                    vTaskDelete(daemon);
+                }
+            }
+            bool res = false;
+            bool const is = system::Interrupt::disableAll();
+            for(int32 i=0; i<SLOTS; i++)
+            {
+                if(slots_[i] == NULL)
+                {
+                    slots_[i] = this;
+                    bit_ = static_cast<uint32>(1) << i;
+                    res = true;
+                    break;
+                }
+            }
+            system::Interrupt::enableAll(is);
+            return res;
+        }
+
+        /**
+         * Executes handlers of signaled resources.
+         *
+         * @param argument unused.
+         */
+        void DeferredInterrupt::main(void*)
+        {
+            while(true)
+            {
+                // The bits are not cleared on waking up, but each one together with looking up its resource
+                if( xTaskNotifyWait(0, 0, NULL, portMAX_DELAY) != pdTRUE ) continue;
+                for(int32 i=0; i<SLOTS; i++)
+                {
+                    uint32 const bit = static_cast<uint32>(1) << i;
+                    bool is = system::Interrupt::disableAll();
+                    bool const isRaised = (ulTaskNotifyValueClear(NULL, bit) & bit) != 0;
+                    DeferredInterrupt* const res = isRaised ? slots_[i] : NULL;
+                    current_ = res;
+                    system::Interrupt::enableAll(is);
+                    if(res == NULL) continue;
+                    static_cast<void>( res->handler_.start() );
+                    if(current_ != res) continue;
+                    is = system::Interrupt::disableAll();
+                    res->isMasked_ = false;
+                    bool const isEnabled = res->isEnabled_;
+                    system::Interrupt::enableAll(is);
+                    if(isEnabled)
+                    {
+                        res->interrupt_.enable(true);
+                    }
+                    current_ = NULL;
+                }
+            }
+        }
+
+        /**
+         * The daemon thread.
+         */
+        TaskHandle_t DeferredInterrupt::daemon_ = NULL;
+
+        /**
+         * The resources indexed by their bits.
+         */
+        DeferredInterrupt* DeferredInterrupt::slots_[DeferredInterrupt::SLOTS];
+
+        /**
+         * The resource which handler is being executed.
+         */
+        DeferredInterrupt* volatile DeferredInterrupt::current_ = NULL;
+    }
+}
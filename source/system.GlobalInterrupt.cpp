@@ -0,0 +1,85 @@
+/**
+ * Hardware global interrupts resource.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2014-2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.GlobalInterrupt.hpp"
+#include "system.Interrupt.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Constructor.
+         */
+        GlobalInterrupt::GlobalInterrupt() : Parent()
+        {
+        }
+
+        /**
+         * Destructor.
+         */
+        GlobalInterrupt::~GlobalInterrupt()
+        {
+        }
+
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool GlobalInterrupt::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+
+        /**
+         * Disables all maskable interrupts.
+         *
+         * The method is not inlined, so its return address is the call site.
+         *
+         * @return global interrupt enable bit value before method was called.
+         */
+        bool GlobalInterrupt::disable()
+        {
+            if( not Self::isUsable() ) return false;
+            return Interrupt::disableAll( __builtin_return_address(0) );
+        }
+
+        /**
+         * Enables all maskable interrupts.
+         *
+         * @param status returned status by disable method.
+         */
+        void GlobalInterrupt::enable(bool const status)
+        {
+            if( not Self::isUsable() ) return;
+            Interrupt::enableAll(status);
+        }
+
+        /**
+         * Copies statistics of call sites.
+         *
+         * @param sites a buffer for statistics.
+         * @param count the maximum number of sites to copy.
+         * @return the number of sites copied.
+         */
+        int32 GlobalInterrupt::getSites(Site* const sites, int32 const count)
+        {
+            return Interrupt::getSites(sites, count);
+        }
+
+        /**
+         * Returns the number of regions of call sites which have not fit the table.
+         *
+         * @return the number of regions.
+         */
+        int64 GlobalInterrupt::getLost()
+        {
+            return Interrupt::getLost();
+        }
+    }
+}
@@ -6,19 +6,57 @@
  * @license   http://embedded.team/license/
  */
 #include "system.Interrupt.hpp"
+#include "system.Clock.hpp"
+#include "system.Trace.hpp"
+#ifdef EOOS_PORT_POSIX
+#include <signal.h>
+#endif
 
 namespace local
 { 
     namespace system
     {
+        #ifdef EOOS_PORT_CORTEX_M
+
+        /**
+         * The NVIC interrupt set-enable register of the external interrupts 0 to 31.
+         */
+        static volatile uint32& NVIC_ISER0 = *reinterpret_cast<volatile uint32*>(0xE000E100);
+
+        /**
+         * The NVIC interrupt clear-enable register of the external interrupts 0 to 31.
+         */
+        static volatile uint32& NVIC_ICER0 = *reinterpret_cast<volatile uint32*>(0xE000E180);
+
+        /**
+         * The NVIC interrupt set-pending register of the external interrupts 0 to 31.
+         */
+        static volatile uint32& NVIC_ISPR0 = *reinterpret_cast<volatile uint32*>(0xE000E200);
+
+        /**
+         * The NVIC interrupt clear-pending register of the external interrupts 0 to 31.
+         */
+        static volatile uint32& NVIC_ICPR0 = *reinterpret_cast<volatile uint32*>(0xE000E280);
+
+        /**
+         * Waits for a write to the NVIC to take effect.
+         */
+        static inline void synchronize()
+        {
+            __asm__ volatile ("dsb 0xF" ::: "memory");
+            __asm__ volatile ("isb 0xF" ::: "memory");
+        }
+
+        #endif // EOOS_PORT_CORTEX_M
+
         /**
          * Constructor.
          *
          * @param handler pointer to user class which implements an interrupt handler interface.   
          * @param source  available interrupt source.
          */
-        Interrupt::Interrupt(api::Task& handler, int32 source) : Parent()
-        {
+        Interrupt::Interrupt(api::Task& handler, int32 source) : Parent(),
+            source_ (-1){
             bool const isConstructed = construct(&handler, source);
             setConstructed( isConstructed );
         }
@@ -28,6 +66,21 @@ namespace local
          */
         Interrupt::~Interrupt()
         {
+            if(source_ < 0) return;
+            uint32 const bit = static_cast<uint32>(1) << source_;
+            #ifdef EOOS_PORT_CORTEX_M
+            NVIC_ICER0 = bit;
+            synchronize();
+            NVIC_ICPR0 = bit;
+            #endif
+            static_cast<void>( enabled_.clearBits(bit) );
+            static_cast<void>( pending_.clearBits(bit) );
+            #ifdef EOOS_PORT_POSIX
+            static_cast<void>( ::signal(SIGRTMIN + source_, SIG_IGN) );
+            #endif
+            bool const is = disableAll();
+            handlers_[source_] = NULL;
+            enableAll(is);
         }
         
         /**
@@ -40,6 +93,27 @@ namespace local
         bool Interrupt::construct(api::Task* handler, int32 source)
         {
             if( not Self::isConstructed() ) return false;
+            if(handler == NULL || source < 0 || source >= SOURCES) return false;
+            #ifdef EOOS_PORT_POSIX
+            if(SIGRTMIN + source > SIGRTMAX) return false;
+            #endif
+            // The source is registered disabled, and a user enables it when it is ready
+            bool const is = disableAll();
+            bool const isFree = handlers_[source] == NULL;
+            if(isFree)
+            {
+                handlers_[source] = handler;
+            }
+            enableAll(is);
+            if( not isFree ) return false;
+            source_ = source;
+            #ifdef EOOS_PORT_POSIX
+            struct ::sigaction action;
+            action.sa_handler = &handleSignal;
+            action.sa_flags = 0;
+            static_cast<void>( ::sigemptyset(&action.sa_mask) );
+            if( ::sigaction(SIGRTMIN + source, &action, NULL) != 0 ) return false;
+            #endif
             return true;
         }
       
@@ -58,6 +132,8 @@ namespace local
          */  
         void Interrupt::jump()
         {
+            if( not Self::isConstructed() ) return;
+            dispatch(source_);
         }
         
         /**
@@ -65,6 +141,12 @@ namespace local
          */  
         void Interrupt::clear()
         {
+            if( not Self::isConstructed() ) return;
+            uint32 const bit = static_cast<uint32>(1) << source_;
+            #ifdef EOOS_PORT_CORTEX_M
+            NVIC_ICPR0 = bit;
+            #endif
+            static_cast<void>( pending_.clearBits(bit) );
         }
         
         /**
@@ -72,6 +154,14 @@ namespace local
          */  
         void Interrupt::set()
         {
+            if( not Self::isConstructed() ) return;
+            #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+            if(triggeredAt_[source_] == 0)
+            {
+                triggeredAt_[source_] = Clock::getTime();
+            }
+            #endif
+            trigger();
         }  
         
         /**
@@ -81,7 +171,14 @@ namespace local
          */    
         bool Interrupt::disable()
         {
-            return false;
+            if( not Self::isConstructed() ) return false;
+            uint32 const bit = static_cast<uint32>(1) << source_;
+            #ifdef EOOS_PORT_CORTEX_M
+            // The hardware is masked first, so the source is not delivered while it is disabled by software
+            NVIC_ICER0 = bit;
+            synchronize();
+            #endif
+            return (enabled_.clearBits(bit) & bit) != 0;
         }
         
         /**
@@ -91,29 +188,513 @@ namespace local
          */
         void Interrupt::enable(bool status)
         {
+            if( not Self::isConstructed() ) return;
+            if( not status ) return;
+            uint32 const bit = static_cast<uint32>(1) << source_;
+            static_cast<void>( enabled_.setBits(bit) );
+            #ifdef EOOS_PORT_CORTEX_M
+            // The hardware delivers a trigger, which has come while the source has been disabled
+            NVIC_ISER0 = bit;
+            #else
+            // A trigger which has come while the source has been disabled is serviced now
+            if( (pending_.load() & bit) != 0 )
+            {
+                trigger();
+            }
+            #endif
         }
+
+        /**
+         * Services an interrupt source.
+         *
+         * @param source an interrupt source.
+         */
+        void Interrupt::dispatch(int32 const source)
+        {
+            if(source < 0 || source >= SOURCES) return;
+            service(source);
+        }
+
+        /**
+         * Services an interrupt source which is available.
+         *
+         * The method is inlined to the trampolines, so each of them reaches the
+         * handler of its source by the constant source.
+         *
+         * @param source an interrupt source.
+         */
+        inline void Interrupt::service(int32 const source)
+        {
+            uint32 const bit = static_cast<uint32>(1) << source;
+            context_++;
+            Trace::record(Trace::INTERRUPT_ENTER, source);
+            #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+            Totals& totals = totals_[source];
+            int64 const begin = Clock::getTime();
+            totals.triggers++;
+            #endif
+            if( (enabled_.load() & bit) == 0 )
+            {
+                static_cast<void>( pending_.setBits(bit) );
+                #ifdef EOOS_PORT_CORTEX_M
+                // The source has been masked by hardware before, so it is delivered again when it is enabled
+                NVIC_ISPR0 = bit;
+                #endif
+            }
+            else
+            {
+                static_cast<void>( pending_.clearBits(bit) );
+                api::Task* const handler = handlers_[source];
+                if(handler != NULL)
+                {
+                    static_cast<void>( handler->start() );
+                }
+                #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+                int64 const duration = Clock::getTime() - begin;
+                totals.executions++;
+                totals.duration += duration;
+                if(totals.maxDuration < duration)
+                {
+                    totals.maxDuration = duration;
+                }
+                if(triggeredAt_[source] != 0)
+                {
+                    int64 const latency = begin - triggeredAt_[source];
+                    triggeredAt_[source] = 0;
+                    totals.latencies++;
+                    totals.latency += latency;
+                    if(totals.maxLatency < latency)
+                    {
+                        totals.maxLatency = latency;
+                    }
+                }
+                #endif
+            }
+            Trace::record(Trace::INTERRUPT_EXIT, source);
+            context_--;
+        }
+
+        /**
+         * Returns the vector of an interrupt source for an interrupt vector table.
+         *
+         * @param source an interrupt source.
+         * @return the vector which dispatches the source, or NULL if the source is not available.
+         */
+        Interrupt::Vector Interrupt::getVector(int32 const source)
+        {
+            if(source < 0 || source >= SOURCES) return NULL;
+            return vectors_[source];
+        }
+
+        /**
+         * Copies statistics of an interrupt source.
+         *
+         * @param source an interrupt source.
+         * @param stats  the statistics.
+         * @return true if the statistics have been copied.
+         */
+        bool Interrupt::getStatistics(int32 const source, Statistics& stats)
+        {
+            #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+            if(source < 0 || source >= SOURCES) return false;
+            bool const is = disableAll();
+            Totals const totals = totals_[source];
+            enableAll(is);
+            // The mean times are calculated out of the critical section
+            stats.triggers = totals.triggers;
+            stats.executions = totals.executions;
+            stats.maxDuration = totals.maxDuration;
+            stats.meanDuration = totals.executions != 0 ? totals.duration / totals.executions : 0;
+            stats.maxLatency = totals.maxLatency;
+            stats.meanLatency = totals.latencies != 0 ? totals.latency / totals.latencies : 0;
+            return true;
+            #else
+            static_cast<void>(source);
+            static_cast<void>(stats);
+            return false;
+            #endif
+        }
+
+        /**
+         * Triggers this source.
+         */
+        void Interrupt::trigger()
+        {
+            #if defined(EOOS_PORT_POSIX)
+            static_cast<void>( ::raise(SIGRTMIN + source_) );
+            #elif defined(EOOS_PORT_CORTEX_M)
+            NVIC_ISPR0 = static_cast<uint32>(1) << source_;
+            #else
+            dispatch(source_);
+            #endif
+        }
+
+        #ifdef EOOS_PORT_POSIX
+
+        /**
+         * Dispatches a POSIX signal.
+         *
+         * @param signal a signal number.
+         */
+        void Interrupt::handleSignal(int const signal)
+        {
+            dispatch(signal - SIGRTMIN);
+        }
+
+        #endif // EOOS_PORT_POSIX
         
         /**
          * Disables all maskable interrupts.
          *
-         * @return global interrupts enable bit value before method was called.
+         * The method is not inlined, so its return address is the call site.
+         *
+         * @return true if the enabling with the status leaves the disabling.
          */
         bool Interrupt::disableAll()
         {
-            return false;
+            #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+            return disableAll( __builtin_return_address(0) );
+            #else
+            return mask();
+            #endif
+        }
+
+        /**
+         * Disables all maskable interrupts on behalf of a call site.
+         *
+         * Only the outermost region of a core is measured, as it contains the nested ones.
+         *
+         * @param site the call site of the disabling.
+         * @return true if the enabling with the status leaves the disabling.
+         */
+        bool Interrupt::disableAll(const void* const site)
+        {
+            bool const is = mask();
+            #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+            if(is)
+            {
+                int32 const core = getCore();
+                if(depth_[core]++ == 0)
+                {
+                    site_[core] = site;
+                    disabledAt_[core] = Clock::getTime();
+                }
+            }
+            #else
+            static_cast<void>(site);
+            #endif
+            return is;
         }
         
         /**
          * Enables all maskable interrupts.
          *
-         * The true passed argument directly turns all maskable interrupts on, 
-         * and the false does nothing, the interrupts stay in the current state.     
+         * The true passed argument leaves a disabling, and the false does nothing,
+         * the interrupts stay in the current state.
          *
          * @param status the returned status by disable method.
          */
-        void Interrupt::enableAll(bool status)
+        void Interrupt::enableAll(bool const status)
+        {
+            #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+            const void* site = NULL;
+            int64 time = 0;
+            if(status)
+            {
+                int32 const core = getCore();
+                if(depth_[core] > 0 && --depth_[core] == 0)
+                {
+                    site = site_[core];
+                    time = Clock::getTime() - disabledAt_[core];
+                    if(maxDisabledTime_ < time)
+                    {
+                        maxDisabledTime_ = time;
+                    }
+                }
+            }
+            unmask(status);
+            // The site table is searched with the interrupts enabled
+            if(site != NULL)
+            {
+                measured(site, time);
+            }
+            #else
+            unmask(status);
+            #endif
+        }
+
+        /**
+         * Returns the longest time all maskable interrupts have been disabled.
+         *
+         * @return time in nanoseconds, or zero if the measurement is disabled.
+         */
+        int64 Interrupt::getMaxDisabledTime()
+        {
+            int64 time = 0;
+            #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+            bool const is = mask();
+            time = maxDisabledTime_;
+            unmask(is);
+            #endif
+            return time;
+        }
+
+        /**
+         * Copies statistics of call sites of disabling all maskable interrupts.
+         *
+         * @param sites a buffer for statistics.
+         * @param count the maximum number of sites to copy.
+         * @return the number of sites copied.
+         */
+        int32 Interrupt::getSites(Site* const sites, int32 const count)
         {
+            int32 length = 0;
+            #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+            bool const is = mask();
+            length = length_.load();
+            length = length < count ? length : count;
+            for(int32 i=0; i<length; i++)
+            {
+                sites[i] = sites_[i];
+            }
+            unmask(is);
+            #else
+            static_cast<void>(sites);
+            static_cast<void>(count);
+            #endif
+            return length > 0 ? length : 0;
         }
 
+        /**
+         * Returns the number of regions of call sites which have not fit the site table.
+         *
+         * @return the number of regions.
+         */
+        int64 Interrupt::getLost()
+        {
+            int64 lost = 0;
+            #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+            bool const is = mask();
+            lost = lost_;
+            unmask(is);
+            #endif
+            return lost;
+        }
+
+        /**
+         * Tests if the execution is in an interrupt service routine.
+         *
+         * @return true if an interrupt is being serviced.
+         */
+        bool Interrupt::isInterrupt()
+        {
+            #if defined(EOOS_PORT_POSIX)
+            return context_ > 0;
+            #elif defined(EOOS_PORT_CORTEX_M)
+            return xPortIsInsideInterrupt() == pdTRUE;
+            #else
+            #error "The interrupt context detection is not implemented for the port"
+            #endif
+        }
+
+        /**
+         * Masks all maskable interrupts without profiling.
+         *
+         * The interrupts are masked up to the maximum kernel call priority only,
+         * so interrupts of higher priorities are never blocked.
+         *
+         * @return true if the unmasking with the status leaves the masking.
+         */
+        bool Interrupt::mask()
+        {
+            bool is = true;
+            if( isInterrupt() )
+            {
+                // A routine is not moved to another core, and nothing preempts it on
+                // its core while the interrupts are disabled, so the masking of the
+                // core is seen by the owner only
+                is = not isMasked_[getCore()];
+                if(is)
+                {
+                    UBaseType_t const mask = taskENTER_CRITICAL_FROM_ISR();
+                    int32 const core = getCore();
+                    mask_[core] = mask;
+                    isMasked_[core] = true;
+                }
+            }
+            else
+            {
+                taskENTER_CRITICAL();
+            }
+            return is;
+        }
+
+        /**
+         * Unmasks all maskable interrupts without profiling.
+         *
+         * @param status the returned status by mask method.
+         */
+        void Interrupt::unmask(bool const status)
+        {
+            if( not status ) return;
+            if( isInterrupt() )
+            {
+                int32 const core = getCore();
+                // An unbalanced call of a routine is ignored
+                if( not isMasked_[core] ) return;
+                isMasked_[core] = false;
+                taskEXIT_CRITICAL_FROM_ISR(mask_[core]);
+            }
+            else
+            {
+                taskEXIT_CRITICAL();
+            }
+        }
+
+        #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+
+        /**
+         * Registers a region of a call site.
+         *
+         * The method is called with the interrupts enabled. The addresses of the table are
+         * set once before the length is increased, so the published sites are searched
+         * without masking, and only the entry update and the search of the sites added
+         * since are done with the interrupts masked.
+         *
+         * @param site the call site of the disabling.
+         * @param time the region time in nanoseconds.
+         */
+        void Interrupt::measured(const void* const site, int64 const time)
+        {
+            int32 length = length_.load();
+            int32 i = 0;
+            while(i < length && sites_[i].address != site)
+            {
+                i++;
+            }
+            bool const is = mask();
+            if(i == length)
+            {
+                length = length_.load();
+                while(i < length && sites_[i].address != site)
+                {
+                    i++;
+                }
+                if(i == length)
+                {
+                    if(length == SITES)
+                    {
+                        lost_++;
+                        unmask(is);
+                        return;
+                    }
+                    sites_[i].address = site;
+                    sites_[i].count = 0;
+                    sites_[i].maxTime = 0;
+                    length_.store(length + 1);
+                }
+            }
+            sites_[i].count++;
+            if(sites_[i].maxTime < time)
+            {
+                sites_[i].maxTime = time;
+            }
+            unmask(is);
+        }
+
+        #endif // EOOS_ENABLE_INTERRUPT_PROFILER
+
+        /**
+         * The interrupt masks saved by the outermost disabling in an interrupt service routine of the cores.
+         */
+        UBaseType_t Interrupt::mask_[Interrupt::CORES];
+
+        /**
+         * The cores, which interrupt service routines have disabled the interrupts.
+         */
+        bool Interrupt::isMasked_[Interrupt::CORES];
+
+        /**
+         * The handlers of the sources.
+         */
+        api::Task* Interrupt::handlers_[Interrupt::SOURCES];
+
+        /**
+         * The trampolines of the sources.
+         */
+        const Interrupt::Vector Interrupt::vectors_[Interrupt::SOURCES] = {
+            &vector<0>,  &vector<1>,  &vector<2>,  &vector<3>,
+            &vector<4>,  &vector<5>,  &vector<6>,  &vector<7>,
+            &vector<8>,  &vector<9>,  &vector<10>, &vector<11>,
+            &vector<12>, &vector<13>, &vector<14>, &vector<15>,
+            &vector<16>, &vector<17>, &vector<18>, &vector<19>,
+            &vector<20>, &vector<21>, &vector<22>, &vector<23>,
+            &vector<24>, &vector<25>, &vector<26>, &vector<27>,
+            &vector<28>, &vector<29>, &vector<30>, &vector<31>
+        };
+
+        /**
+         * The enabled sources.
+         */
+        Atomic<uint32> Interrupt::enabled_(0);
+
+        /**
+         * The pending sources.
+         */
+        Atomic<uint32> Interrupt::pending_(0);
+
+        /**
+         * The nesting depth of dispatching sources.
+         */
+        volatile int32 Interrupt::context_ = 0;
+
+        #ifdef EOOS_ENABLE_INTERRUPT_PROFILER
+
+        /**
+         * The nesting depths of disabling all maskable interrupts of the cores.
+         */
+        int32 Interrupt::depth_[Interrupt::CORES];
+
+        /**
+         * The times of the outermost disabling of the cores.
+         */
+        int64 Interrupt::disabledAt_[Interrupt::CORES];
+
+        /**
+         * The longest time all maskable interrupts have been disabled.
+         */
+        int64 Interrupt::maxDisabledTime_ = 0;
+
+        /**
+         * The call sites of the outermost disabling of the cores.
+         */
+        const void* Interrupt::site_[Interrupt::CORES];
+
+        /**
+         * The statistics of call sites.
+         */
+        Interrupt::Site Interrupt::sites_[Interrupt::SITES];
+
+        /**
+         * The number of call sites.
+         */
+        Atomic<int32> Interrupt::length_(0);
+
+        /**
+         * The number of regions of call sites which have not fit the site table.
+         */
+        int64 Interrupt::lost_ = 0;
+
+        /**
+         * The running totals of the statistics of the sources.
+         */
+        Interrupt::Totals Interrupt::totals_[Interrupt::SOURCES];
+
+        /**
+         * The times the sources have been set by software at.
+         */
+        int64 Interrupt::triggeredAt_[Interrupt::SOURCES];
+
+        #endif // EOOS_ENABLE_INTERRUPT_PROFILER
     }
 }
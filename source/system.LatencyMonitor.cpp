@@ -0,0 +1,188 @@
+/**
+ * Scheduling latency monitor class.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.LatencyMonitor.hpp"
+#include "system.Interrupt.hpp"
+#include "system.Timeout.hpp"
+#include "system.Clock.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Constructor.
+         *
+         * @param period    a period of wake-ups in milliseconds.
+         * @param priority  a priority of the monitor thread.
+         * @param threshold a latency in nanoseconds, exceeding which is notified.
+         * @param listener  a listener of exceeding latencies, or NULL.
+         */
+        LatencyMonitor::LatencyMonitor(int64 const period, int32 const priority, int64 const threshold, LatencyListener* const listener) : Parent(),
+            period_     (Timeout::toTicks(period)),
+            threshold_  (threshold),
+            listener_   (listener),
+            task_       (NULL),
+            isStopping_ (false),
+            isStopped_  (false),
+            isExceeded_ (false){
+            reset();
+            bool const isConstructed = construct(priority);
+            setConstructed( isConstructed );
+        }
+
+        /**
+         * Destructor.
+         */
+        LatencyMonitor::~LatencyMonitor()
+        {
+            if(task_ == NULL) return;
+            isStopping_.store(true);
+            // The thread stops after its next wake-up, and deletes itself
+            while( not isStopped_.load() )
+            {
+                vTaskDelay(period_);
+            }
+        }
+
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool LatencyMonitor::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+
+        /**
+         * Tests if this resource is blocked.
+         *
+         * @return true if a latency has exceeded the threshold.
+         */
+        bool LatencyMonitor::isBlocked() const
+        {
+            if( not Self::isConstructed() ) return false;
+            return isExceeded_.load();
+        }
+
+        /**
+         * Copies the statistics.
+         *
+         * @param stats the statistics.
+         */
+        void LatencyMonitor::getStatistics(Statistics& stats) const
+        {
+            bool const is = Interrupt::disableAll();
+            stats = stats_;
+            Interrupt::enableAll(is);
+            // The mean latency is calculated out of the critical section
+            stats.mean = stats.count != 0 ? stats.mean / stats.count : 0;
+            if(stats.count == 0)
+            {
+                stats.min = 0;
+            }
+        }
+
+        /**
+         * Resets the statistics.
+         */
+        void LatencyMonitor::reset()
+        {
+            bool const is = Interrupt::disableAll();
+            stats_.count = 0;
+            stats_.min = 0x7FFFFFFFFFFFFFFFLL;
+            stats_.mean = 0;
+            stats_.max = 0;
+            for(int32 i=0; i<BUCKETS; i++)
+            {
+                stats_.histogram[i] = 0;
+            }
+            Interrupt::enableAll(is);
+            isExceeded_.store(false);
+        }
+
+        /**
+         * Constructor.
+         *
+         * @param priority a priority of the monitor thread.
+         * @return true if object has been constructed successfully.
+         */
+        bool LatencyMonitor::construct(int32 const priority)
+        {
+            if( not Self::isConstructed() ) return false;
+            if(period_ == 0) return false;
+            if(priority < 0 || priority >= configMAX_PRIORITIES) return false;
+            return xTaskCreate(&main, "LATENCY", STACK_SIZE, this, static_cast<UBaseType_t>(priority), &task_) == pdPASS;
+        }
+
+        /**
+         * Registers a latency.
+         *
+         * @param latency a latency in nanoseconds.
+         */
+        void LatencyMonitor::measured(int64 const latency)
+        {
+            // A bucket is the position of the most significant bit of the latency
+            int32 bucket = 0;
+            for(uint64 value = static_cast<uint64>(latency) >> 1; value != 0 && bucket < BUCKETS - 1; value >>= 1)
+            {
+                bucket++;
+            }
+            bool const is = Interrupt::disableAll();
+            stats_.count++;
+            stats_.mean += latency;
+            if(stats_.min > latency)
+            {
+                stats_.min = latency;
+            }
+            if(stats_.max < latency)
+            {
+                stats_.max = latency;
+            }
+            stats_.histogram[bucket]++;
+            Interrupt::enableAll(is);
+            if(latency > threshold_)
+            {
+                isExceeded_.store(true);
+                if(listener_ != NULL)
+                {
+                    listener_->exceeded(latency);
+                }
+            }
+        }
+
+        /**
+         * Wakes up periodically, and measures latencies.
+         *
+         * @param argument the monitor.
+         */
+        void LatencyMonitor::main(void* const argument)
+        {
+            LatencyMonitor& monitor = *static_cast<LatencyMonitor*>(argument);
+            int64 const tick = 1000000000 / configTICK_RATE_HZ;
+            int64 const period = static_cast<int64>(monitor.period_) * tick;
+            // The monitor is armed at a tick boundary, as the kernel wakes the thread up at them
+            vTaskDelay(1);
+            int64 intended = Clock::getTime();
+            while( not monitor.isStopping_.load() )
+            {
+                intended += period;
+                // The thread sleeps for the ticks left to the intended time by the clock, or does not sleep if it is late
+                int64 const left = intended - Clock::getTime();
+                if(left > 0)
+                {
+                    vTaskDelay( static_cast<TickType_t>( (left + tick - 1) / tick ) );
+                }
+                int64 const latency = Clock::getTime() - intended;
+                monitor.measured(latency > 0 ? latency : 0);
+            }
+            monitor.isStopped_.store(true);
+            vTaskDelete(NULL);
+        }
+    }
+}
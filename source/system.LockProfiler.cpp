@@ -0,0 +1,108 @@
+/**
+ * Contention profiler of a lock.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.LockProfiler.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Constructor.
+         *
+         * @param name a lock name, or NULL.
+         */
+        LockProfiler::LockProfiler(const char* const name) :
+            name_ (name){
+            #ifdef EOOS_ENABLE_LOCK_PROFILER
+            stats_.name = name;
+            stats_.acquisitions = 0;
+            stats_.contentions = 0;
+            stats_.waitTime = 0;
+            stats_.maxWaitTime = 0;
+            stats_.maxHoldTime = 0;
+            lockedAt_ = 0;
+            bool const is = Interrupt::disableAll();
+            next_ = head_;
+            head_ = this;
+            Interrupt::enableAll(is);
+            #endif
+        }
+
+        /**
+         * Destructor.
+         */
+        LockProfiler::~LockProfiler()
+        {
+            #ifdef EOOS_ENABLE_LOCK_PROFILER
+            bool const is = Interrupt::disableAll();
+            LockProfiler** link = &head_;
+            while(*link != NULL)
+            {
+                if(*link == this)
+                {
+                    *link = next_;
+                    break;
+                }
+                link = &(*link)->next_;
+            }
+            Interrupt::enableAll(is);
+            #endif
+        }
+
+        /**
+         * Copies statistics of the hottest locks.
+         *
+         * @param stats an array for the statistics.
+         * @param count the array length.
+         * @return the number of copied statistics.
+         */
+        int32 LockProfiler::getHottest(Statistics* const stats, int32 const count)
+        {
+            int32 length = 0;
+            #ifdef EOOS_ENABLE_LOCK_PROFILER
+            if(stats == NULL) return 0;
+            bool const is = Interrupt::disableAll();
+            for(LockProfiler* profiler = head_; profiler != NULL; profiler = profiler->next_)
+            {
+                // Insert the statistics into the array sorted by waiting time
+                int32 index = length;
+                while(index > 0 && stats[index - 1].waitTime < profiler->stats_.waitTime)
+                {
+                    if(index < count)
+                    {
+                        stats[index] = stats[index - 1];
+                    }
+                    index--;
+                }
+                if(index < count)
+                {
+                    stats[index] = profiler->stats_;
+                    if(length < count)
+                    {
+                        length++;
+                    }
+                }
+            }
+            Interrupt::enableAll(is);
+            #else
+            static_cast<void>(stats);
+            static_cast<void>(count);
+            #endif
+            return length;
+        }
+
+        #ifdef EOOS_ENABLE_LOCK_PROFILER
+
+        /**
+         * The first profiler of the profilers list.
+         */
+        LockProfiler* LockProfiler::head_ = NULL;
+
+        #endif // EOOS_ENABLE_LOCK_PROFILER
+    }
+}
@@ -0,0 +1,314 @@
+/**
+ * Zero-copy message buffer class.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.MessageBuffer.hpp"
+#include "system.Allocator.hpp"
+#include "system.Interrupt.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Constructor.
+         *
+         * @param capacity the buffer size in bytes, which is rounded up to a power of two.
+         */
+        MessageBuffer::MessageBuffer(size_t const capacity) : Parent(),
+            buf_          (NULL),
+            capacity_     (0),
+            written_      (0),
+            read_         (0),
+            reserved_     (0),
+            skipped_      (0),
+            pending_      (0),
+            senders_      (0),
+            receivers_    (0),
+            sendQueue_    (true),
+            receiveQueue_ (true){
+            bool const isConstructed = construct(capacity);
+            setConstructed( isConstructed );
+        }
+
+        /**
+         * Destructor.
+         */
+        MessageBuffer::~MessageBuffer()
+        {
+            Allocator::free(buf_);
+        }
+
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool MessageBuffer::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+
+        /**
+         * Reserves space for a message, and sleeps until the buffer has the space.
+         *
+         * @param size the maximum size of the message in bytes.
+         * @return the address of the message space, or NULL if an error has been occurred.
+         */
+        void* MessageBuffer::reserve(size_t const size)
+        {
+            if( not Self::isConstructed() ) return NULL;
+            if( size > getMaxSize() ) return NULL;
+            // The previous message has to be committed first
+            if( reserved_ != 0 ) return NULL;
+            while(true)
+            {
+                void* msg = place(size);
+                if(msg != NULL) return msg;
+                WaitQueue::Waiter waiter(1);
+                bool const is = Interrupt::disableAll();
+                // Announce the waiter before the last try, as the receiver
+                // either sees the waiter, or its released space is seen by the try
+                static_cast<void>( senders_.add(1) );
+                msg = place(size);
+                if(msg != NULL)
+                {
+                    static_cast<void>( senders_.subtract(1) );
+                }
+                else
+                {
+                    sendQueue_.add(waiter);
+                }
+                Interrupt::enableAll(is);
+                if(msg != NULL) return msg;
+                WaitQueue::wait(waiter);
+            }
+        }
+
+        /**
+         * Reserves space for a message if the buffer has the space.
+         *
+         * @param size the maximum size of the message in bytes.
+         * @return the address of the message space, or NULL if the buffer has no space.
+         */
+        void* MessageBuffer::tryReserve(size_t const size)
+        {
+            if( not Self::isConstructed() ) return NULL;
+            if( size > getMaxSize() ) return NULL;
+            return place(size);
+        }
+
+        /**
+         * Passes the reserved message to the receiver.
+         *
+         * @param size the actual size of the message, which does not exceed the reserved size.
+         */
+        void MessageBuffer::commit(size_t const size)
+        {
+            if( not Self::isConstructed() ) return;
+            if( reserved_ == 0 ) return;
+            uint32 const frame = toFrame(size);
+            if( frame > reserved_ - skipped_ ) return;
+            uint32 const written = written_.load();
+            uint32 const offset = (written + skipped_) & (capacity_ - 1);
+            *reinterpret_cast<uint32*>(&buf_[offset]) = static_cast<uint32>(size);
+            // Publish the frame only after its length word has been written
+            written_.store(written + skipped_ + frame);
+            reserved_ = 0;
+            skipped_ = 0;
+            wake(receiveQueue_, receivers_);
+        }
+
+        /**
+         * Reads a message, and sleeps until the buffer has a message.
+         *
+         * @param size the size of the message in bytes.
+         * @return the address of the message, or NULL if an error has been occurred.
+         */
+        const void* MessageBuffer::read(size_t& size)
+        {
+            if( not Self::isConstructed() ) return NULL;
+            // The previous message has to be released first
+            if( pending_ != 0 ) return NULL;
+            while(true)
+            {
+                const void* msg = find(size);
+                if(msg != NULL) return msg;
+                WaitQueue::Waiter waiter(1);
+                bool const is = Interrupt::disableAll();
+                // Announce the waiter before the last try, as the sender
+                // either sees the waiter, or its committed message is seen by the try
+                static_cast<void>( receivers_.add(1) );
+                msg = find(size);
+                if(msg != NULL)
+                {
+                    static_cast<void>( receivers_.subtract(1) );
+                }
+                else
+                {
+                    receiveQueue_.add(waiter);
+                }
+                Interrupt::enableAll(is);
+                if(msg != NULL) return msg;
+                WaitQueue::wait(waiter);
+            }
+        }
+
+        /**
+         * Reads a message if the buffer has a message.
+         *
+         * @param size the size of the message in bytes.
+         * @return the address of the message, or NULL if the buffer is empty.
+         */
+        const void* MessageBuffer::tryRead(size_t& size)
+        {
+            if( not Self::isConstructed() ) return NULL;
+            if( pending_ != 0 ) return NULL;
+            return find(size);
+        }
+
+        /**
+         * Returns the space of the read message to the sender.
+         */
+        void MessageBuffer::release()
+        {
+            if( not Self::isConstructed() ) return;
+            if( pending_ == 0 ) return;
+            read_.store(read_.load() + pending_);
+            pending_ = 0;
+            wake(sendQueue_, senders_);
+        }
+
+        /**
+         * Returns the maximum size of a message.
+         *
+         * @return the size in bytes.
+         */
+        size_t MessageBuffer::getMaxSize() const
+        {
+            if( not Self::isConstructed() ) return 0;
+            // A frame of this size always fits either at the end or at the beginning
+            return static_cast<size_t>( (capacity_ >> 1) - sizeof(uint32) );
+        }
+
+        /**
+         * Tests if this resource is blocked.
+         *
+         * @return true if the buffer is empty.
+         */
+        bool MessageBuffer::isBlocked() const
+        {
+            if( not Self::isConstructed() ) return false;
+            return written_.load() == read_.load();
+        }
+
+        /**
+         * Constructor.
+         *
+         * @param capacity the buffer size in bytes.
+         * @return true if object has been constructed successfully.
+         */
+        bool MessageBuffer::construct(size_t const capacity)
+        {
+            if( not Self::isConstructed() ) return false;
+            if(capacity < 16 || capacity > 0x80000000) return false;
+            uint32 length = 16;
+            while(length < capacity)
+            {
+                length <<= 1;
+            }
+            buf_ = static_cast<uint8*>( Allocator::allocate(length) );
+            if(buf_ == NULL) return false;
+            capacity_ = length;
+            return true;
+        }
+
+        /**
+         * Places a frame for a message.
+         *
+         * @param size the size of the message in bytes.
+         * @return the address of the message space, or NULL if the buffer has no space.
+         */
+        void* MessageBuffer::place(size_t const size)
+        {
+            if( reserved_ != 0 ) return NULL;
+            uint32 const frame = toFrame(size);
+            uint32 const written = written_.load();
+            uint32 const free = capacity_ - (written - read_.load());
+            uint32 const offset = written & (capacity_ - 1);
+            uint32 const tail = capacity_ - offset;
+            uint32 const skip = tail < frame ? tail : 0;
+            if( free < skip + frame ) return NULL;
+            if( skip != 0 )
+            {
+                *reinterpret_cast<uint32*>(&buf_[offset]) = SKIP;
+            }
+            skipped_ = skip;
+            reserved_ = skip + frame;
+            return &buf_[ ( (offset + skip) & (capacity_ - 1) ) + sizeof(uint32) ];
+        }
+
+        /**
+         * Finds the frame of the next message.
+         *
+         * @param size the size of the message in bytes.
+         * @return the address of the message, or NULL if the buffer is empty.
+         */
+        const void* MessageBuffer::find(size_t& size)
+        {
+            uint32 const read = read_.load();
+            if( written_.load() == read ) return NULL;
+            uint32 offset = read & (capacity_ - 1);
+            uint32 skip = 0;
+            uint32 length = *reinterpret_cast<const uint32*>(&buf_[offset]);
+            if(length == SKIP)
+            {
+                skip = capacity_ - offset;
+                offset = 0;
+                length = *reinterpret_cast<const uint32*>(&buf_[offset]);
+            }
+            pending_ = skip + toFrame(length);
+            size = static_cast<size_t>(length);
+            return &buf_[offset + sizeof(uint32)];
+        }
+
+        /**
+         * Wakes up a thread waiting in a queue.
+         *
+         * @param queue   a wait queue.
+         * @param waiters the number of threads in the wait queue.
+         */
+        void MessageBuffer::wake(WaitQueue& queue, Atomic<int32>& waiters)
+        {
+            if( waiters.load() == 0 ) return;
+            BaseType_t isWoken = pdFALSE;
+            BaseType_t* const woken = Interrupt::isInterrupt() ? &isWoken : NULL;
+            bool const is = Interrupt::disableAll();
+            if( not queue.isEmpty() )
+            {
+                static_cast<void>( waiters.subtract(1) );
+                queue.signalFirst(woken);
+            }
+            Interrupt::enableAll(is);
+            if(woken != NULL)
+            {
+                portYIELD_FROM_ISR(isWoken);
+            }
+        }
+
+        /**
+         * Returns a frame size of a message.
+         *
+         * @param size the size of the message in bytes.
+         * @return the frame size aligned to the length word.
+         */
+        uint32 MessageBuffer::toFrame(size_t const size)
+        {
+            uint32 const mask = sizeof(uint32) - 1;
+            return ( static_cast<uint32>(size) + sizeof(uint32) + mask ) & ~mask;
+        }
+    }
+}
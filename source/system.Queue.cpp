@@ -0,0 +1,398 @@
+/**
+ * Bounded message queue class.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.Queue.hpp"
+#include "system.Allocator.hpp"
+#include "system.Interrupt.hpp"
+#include <new>
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Constructor.
+         *
+         * @param capacity the maximum number of messages, which is rounded up to a power of two.
+         * @param size     the size of a message in bytes.
+         */
+        Queue::Queue(int32 const capacity, size_t const size) : Parent(),
+            seqs_         (NULL),
+            msgs_         (NULL),
+            size_         (size),
+            mask_         (0),
+            head_         (0),
+            tail_         (0),
+            senders_      (0),
+            receivers_    (0),
+            sendQueue_    (false),
+            receiveQueue_ (false){
+            bool const isConstructed = construct(capacity, size);
+            setConstructed( isConstructed );
+        }
+
+        /**
+         * Destructor.
+         */
+        Queue::~Queue()
+        {
+            Allocator::free(msgs_);
+            Allocator::free(seqs_);
+        }
+
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool Queue::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+
+        /**
+         * Sends a message, and sleeps until the queue has space for it.
+         *
+         * @param msg a message to copy to the queue.
+         * @return true if the message has been sent.
+         */
+        bool Queue::send(const void* const msg)
+        {
+            if( not Self::isConstructed() ) return false;
+            while( not trySend(msg) )
+            {
+                WaitQueue::Waiter waiter(1);
+                bool const is = Interrupt::disableAll();
+                // Announce the waiter before the last try, as a receiving thread
+                // either sees the waiter, or its freed cell is seen by the try
+                static_cast<void>( senders_.add(1) );
+                bool const isSent = push(msg);
+                if(isSent)
+                {
+                    static_cast<void>( senders_.subtract(1) );
+                }
+                else
+                {
+                    sendQueue_.add(waiter);
+                }
+                Interrupt::enableAll(is);
+                if(isSent)
+                {
+                    wake(receiveQueue_, receivers_, 1);
+                    break;
+                }
+                // A woken thread tries again, as other senders might overtake it
+                WaitQueue::wait(waiter);
+            }
+            return true;
+        }
+
+        /**
+         * Sends a message if the queue has space for it.
+         *
+         * @param msg a message to copy to the queue.
+         * @return true if the message has been sent.
+         */
+        bool Queue::trySend(const void* const msg)
+        {
+            if( not Self::isConstructed() ) return false;
+            if( not push(msg) ) return false;
+            wake(receiveQueue_, receivers_, 1);
+            return true;
+        }
+
+        /**
+         * Sends messages while the queue has space for them.
+         *
+         * @param msgs  an array of messages to copy to the queue.
+         * @param count the number of messages in the array.
+         * @return the number of sent messages.
+         */
+        int32 Queue::trySend(const void* const msgs, int32 const count)
+        {
+            if( not Self::isConstructed() ) return 0;
+            if(msgs == NULL) return 0;
+            const uint8* msg = static_cast<const uint8*>(msgs);
+            int32 sent = 0;
+            while(sent < count)
+            {
+                if( not push(msg) ) break;
+                msg += size_;
+                sent++;
+            }
+            // Wake up all the threads which can receive the messages at once
+            wake(receiveQueue_, receivers_, sent);
+            return sent;
+        }
+
+        /**
+         * Sends a message from an interrupt service routine if the queue has space for it.
+         *
+         * @param msg a message to copy to the queue.
+         * @return true if the message has been sent.
+         */
+        bool Queue::sendFromInterrupt(const void* const msg)
+        {
+            if( not Self::isConstructed() ) return false;
+            if( not push(msg) ) return false;
+            if( receivers_.load() != 0 )
+            {
+                BaseType_t isWoken = pdFALSE;
+                bool const is = Interrupt::disableAll();
+                if( not receiveQueue_.isEmpty() )
+                {
+                    static_cast<void>( receivers_.subtract(1) );
+                    receiveQueue_.signalFirstFromInterrupt(&isWoken);
+                }
+                Interrupt::enableAll(is);
+                portYIELD_FROM_ISR(isWoken);
+            }
+            return true;
+        }
+
+        /**
+         * Receives a message, and sleeps until the queue has a message.
+         *
+         * @param msg a buffer to copy a message to.
+         * @return true if a message has been received.
+         */
+        bool Queue::receive(void* const msg)
+        {
+            if( not Self::isConstructed() ) return false;
+            while( not tryReceive(msg) )
+            {
+                WaitQueue::Waiter waiter(1);
+                bool const is = Interrupt::disableAll();
+                // Announce the waiter before the last try, as a sending thread
+                // either sees the waiter, or its message is seen by the try
+                static_cast<void>( receivers_.add(1) );
+                bool const isReceived = pop(msg);
+                if(isReceived)
+                {
+                    static_cast<void>( receivers_.subtract(1) );
+                }
+                else
+                {
+                    receiveQueue_.add(waiter);
+                }
+                Interrupt::enableAll(is);
+                if(isReceived)
+                {
+                    wake(sendQueue_, senders_, 1);
+                    break;
+                }
+                // A woken thread tries again, as other receivers might overtake it
+                WaitQueue::wait(waiter);
+            }
+            return true;
+        }
+
+        /**
+         * Receives a message if the queue has a message.
+         *
+         * @param msg a buffer to copy a message to.
+         * @return true if a message has been received.
+         */
+        bool Queue::tryReceive(void* const msg)
+        {
+            if( not Self::isConstructed() ) return false;
+            if( not pop(msg) ) return false;
+            wake(sendQueue_, senders_, 1);
+            return true;
+        }
+
+        /**
+         * Receives messages while the queue has them.
+         *
+         * @param msgs  an array to copy messages to.
+         * @param count the number of messages the array can hold.
+         * @return the number of received messages.
+         */
+        int32 Queue::tryReceive(void* const msgs, int32 const count)
+        {
+            if( not Self::isConstructed() ) return 0;
+            if(msgs == NULL) return 0;
+            uint8* msg = static_cast<uint8*>(msgs);
+            int32 received = 0;
+            while(received < count)
+            {
+                if( not pop(msg) ) break;
+                msg += size_;
+                received++;
+            }
+            // Wake up all the threads which can send to the freed cells at once
+            wake(sendQueue_, senders_, received);
+            return received;
+        }
+
+        /**
+         * Returns the number of messages in the queue.
+         *
+         * @return the number of messages.
+         */
+        int32 Queue::getLength() const
+        {
+            if( not Self::isConstructed() ) return 0;
+            return static_cast<int32>( tail_.load() - head_.load() );
+        }
+
+        /**
+         * Returns the maximum number of messages in the queue.
+         *
+         * @return the capacity.
+         */
+        int32 Queue::getCapacity() const
+        {
+            if( not Self::isConstructed() ) return 0;
+            return static_cast<int32>(mask_) + 1;
+        }
+
+        /**
+         * Tests if this resource is blocked.
+         *
+         * @return true if the queue is empty, or is full.
+         */
+        bool Queue::isBlocked() const
+        {
+            if( not Self::isConstructed() ) return false;
+            int32 const length = getLength();
+            return length <= 0 || length >= getCapacity();
+        }
+
+        /**
+         * Constructor.
+         *
+         * @param capacity the maximum number of messages.
+         * @param size     the size of a message in bytes.
+         * @return true if object has been constructed successfully.
+         */
+        bool Queue::construct(int32 const capacity, size_t const size)
+        {
+            if( not Self::isConstructed() ) return false;
+            if(capacity < 1 || capacity > 0x40000000) return false;
+            if(size == 0) return false;
+            uint32 length = 1;
+            while(length < static_cast<uint32>(capacity))
+            {
+                length <<= 1;
+            }
+            if(size > static_cast<size_t>(-1) / length) return false;
+            seqs_ = static_cast< Atomic<uint32>* >( Allocator::allocate(sizeof(Atomic<uint32>) * length) );
+            if(seqs_ == NULL) return false;
+            msgs_ = static_cast<uint8*>( Allocator::allocate(size * length) );
+            if(msgs_ == NULL) return false;
+            for(uint32 i=0; i<length; i++)
+            {
+                // A cell is free for sending at the position equal to its sequence number
+                static_cast<void>( new (&seqs_[i]) Atomic<uint32>(i) );
+            }
+            mask_ = length - 1;
+            return true;
+        }
+
+        /**
+         * Copies a message to the queue.
+         *
+         * @param msg a message.
+         * @return true if the message has been copied.
+         */
+        bool Queue::push(const void* const msg)
+        {
+            uint32 pos = tail_.load();
+            while(true)
+            {
+                int32 const diff = static_cast<int32>( seqs_[pos & mask_].load() - pos );
+                if(diff == 0)
+                {
+                    if( tail_.compareAndSwap(pos, pos + 1) ) break;
+                }
+                else if(diff < 0)
+                {
+                    // The cell still has a message of the previous lap
+                    return false;
+                }
+                pos = tail_.load();
+            }
+            uint32 const index = pos & mask_;
+            copy(&msgs_[index * size_], msg, size_);
+            seqs_[index].store(pos + 1);
+            return true;
+        }
+
+        /**
+         * Copies a message from the queue.
+         *
+         * @param msg a buffer for a message.
+         * @return true if the message has been copied.
+         */
+        bool Queue::pop(void* const msg)
+        {
+            uint32 pos = head_.load();
+            while(true)
+            {
+                int32 const diff = static_cast<int32>( seqs_[pos & mask_].load() - (pos + 1) );
+                if(diff == 0)
+                {
+                    if( head_.compareAndSwap(pos, pos + 1) ) break;
+                }
+                else if(diff < 0)
+                {
+                    // The cell has not got a message of this lap yet
+                    return false;
+                }
+                pos = head_.load();
+            }
+            uint32 const index = pos & mask_;
+            copy(msg, &msgs_[index * size_], size_);
+            seqs_[index].store(pos + mask_ + 1);
+            return true;
+        }
+
+        /**
+         * Wakes up threads waiting in a queue.
+         *
+         * @param queue   a wait queue.
+         * @param waiters the number of threads in the wait queue.
+         * @param count   the maximum number of threads to wake up.
+         */
+        void Queue::wake(WaitQueue& queue, Atomic<int32>& waiters, int32 count)
+        {
+            if(count < 1 || waiters.load() == 0) return;
+            BaseType_t isWoken = pdFALSE;
+            BaseType_t* const woken = Interrupt::isInterrupt() ? &isWoken : NULL;
+            bool const is = Interrupt::disableAll();
+            while(count > 0 && not queue.isEmpty())
+            {
+                static_cast<void>( waiters.subtract(1) );
+                queue.signalFirst(woken);
+                count--;
+            }
+            Interrupt::enableAll(is);
+            if(woken != NULL)
+            {
+                portYIELD_FROM_ISR(isWoken);
+            }
+        }
+
+        /**
+         * Copies memory.
+         *
+         * @param dst  a destination address.
+         * @param src  a source address.
+         * @param size a number of bytes.
+         */
+        void Queue::copy(void* const dst, const void* const src, size_t const size)
+        {
+            uint8* d = static_cast<uint8*>(dst);
+            const uint8* s = static_cast<const uint8*>(src);
+            for(size_t i=0; i<size; i++)
+            {
+                d[i] = s[i];
+            }
+        }
+    }
+}
@@ -9,6 +9,7 @@
 #include "system.SchedulerThread.hpp"
 #include "system.System.hpp"
 #include "system.Interrupt.hpp"
+#include "system.Trace.hpp"
 
 namespace local
 {
@@ -48,41 +49,16 @@ namespace local
          */
         api::Thread* Scheduler::createThread(api::Task& task)
         {
-            if( not Self::isConstructed() ) return NULL;
+            if( not Self::isUsable() ) return NULL;
             SchedulerThread* thread = new SchedulerThread(task, this);
             if(thread == NULL) return NULL; 
-            if(thread->isConstructed()) return thread;  
-            delete thread;
-            return NULL;
-        }
-        
-        /**
-         * Returns currently executing thread.
-         *
-         * @return executing thread.
-         */
-        api::Thread& Scheduler::getCurrentThread() const
-        {
-            if( not Self::isConstructed() ) 
-            {
-                System::terminate(ERROR_SYSCALL_CALLED);
-            }
-            bool const is = Interrupt::disableAll();
-            api::Thread* thread = NULL;
-            int64 id = -1; // TODO: get a current thread ID static_cast<int64>( gettid() );
-            int32 length = threads_.getLength();
-            for(int32 i=0; i<length; i++)
+            if(thread->isConstructed())
             {
-                thread = threads_.get(i);
-                if(thread == NULL) break;
-                if(thread->getId() == id) break;
+                Trace::record(Trace::THREAD_OBJECT_CREATE, thread);
+                return thread;
             }
-            if(thread == NULL) 
-            {
-                System::terminate(ERROR_RESOURCE_NOT_FOUND);
-            }
-            Interrupt::enableAll(is);
-            return *thread;
+            delete thread;
+            return NULL;
         }
         
         /**
@@ -90,7 +66,7 @@ namespace local
          */
         void Scheduler::yield()
         {
-            if( not Self::isConstructed() )
+            if( not Self::isUsable() )
             {
                 System::terminate(ERROR_SYSCALL_CALLED);
             }                
@@ -124,6 +100,16 @@ namespace local
             return true;      
         }
         
+        /**
+         * Terminates the operating system execution.
+         *
+         * @param error a termination status code.
+         */
+        void Scheduler::terminate(Error const error)
+        {
+            System::terminate(error);
+        }
+
         /**
          * Adds a thread to execution list
          *
@@ -131,7 +117,7 @@ namespace local
          */
         bool Scheduler::addThread(SchedulerThread* thread)
         {
-            if( not Self::isConstructed() ) return false;
+            if( not Self::isUsable() ) return false;
             bool const is = Interrupt::disableAll();
             bool res = threads_.add(thread);
             Interrupt::enableAll(is);
@@ -145,7 +131,7 @@ namespace local
          */
         void Scheduler::removeThread(SchedulerThread* thread)
         {
-            if( not Self::isConstructed() ) return;
+            if( not Self::isUsable() ) return;
             bool const is = Interrupt::disableAll();
             threads_.removeElement(thread);
             Interrupt::enableAll(is);
@@ -8,7 +8,17 @@
 #include "system.System.hpp"
 #include "system.Mutex.hpp"
 #include "system.Semaphore.hpp"
+#include "system.ReadWriteLock.hpp"
+#include "system.Queue.hpp"
+#include "system.MessageBuffer.hpp"
+#include "system.EventGroup.hpp"
+#include "system.ConditionVariable.hpp"
 #include "system.Interrupt.hpp"
+#include "system.DeferredInterrupt.hpp"
+#include "system.Clock.hpp"
+#include "system.TraceExporter.hpp"
+#include "system.LatencyMonitor.hpp"
+#include "system.Timeline.hpp"
 #include "Program.hpp"
 
 namespace local
@@ -29,12 +39,18 @@ namespace local
          * Constructor.
          */    
         System::System() : Parent(),
-            config_    (),
-            heap_      (),
-            cpu_       (config_),
-            gi_        (),
-            runtime_   (),
-            scheduler_ (){
+            config_         (),
+            cpuStage_       (Timeline::begin("cpu")),
+            cpu_            (config_),
+            heapStage_      (Timeline::next(cpuStage_, "heap")),
+            heap_           (),
+            giStage_        (Timeline::next(heapStage_, "global_interrupt")),
+            gi_             (),
+            runtimeStage_   (Timeline::next(giStage_, "runtime")),
+            runtime_        (),
+            schedulerStage_ (Timeline::next(runtimeStage_, "scheduler")),
+            scheduler_      (){
+            Timeline::end(schedulerStage_);
             bool const isConstructed = construct();
             setConstructed( isConstructed );
         }
@@ -63,7 +79,7 @@ namespace local
          */
         int64 System::getTime() const
         {
-            return 0;
+            return Clock::getTime();
         }
 
         /**
@@ -73,7 +89,7 @@ namespace local
          */
         api::Heap& System::getHeap() const
         {
-            if( not Self::isConstructed() )
+            if( not Self::isUsable() )
             {
                 terminate(ERROR_SYSCALL_CALLED);
             }
@@ -87,7 +103,7 @@ namespace local
          */
         api::Runtime& System::getRuntime() const
         {
-            if( not Self::isConstructed() )
+            if( not Self::isUsable() )
             {
                 terminate(ERROR_SYSCALL_CALLED);
             }
@@ -101,7 +117,7 @@ namespace local
          */
         api::Toggle& System::getGlobalInterrupt() const
         {
-            if( not Self::isConstructed() )
+            if( not Self::isUsable() )
             {
                 terminate(ERROR_SYSCALL_CALLED);
             }
@@ -109,27 +125,38 @@ namespace local
         }
 
         /**
-         * Returns the kernel scheduler.
+         * Creates a new mutex resource.
          *
-         * @return the kernel scheduler.
+         * @return a new mutex resource, or NULL if an error has been occurred.
          */
-        api::Scheduler& System::getScheduler() const
+        api::Mutex* System::createMutex()
         {
-            if( not Self::isConstructed() )
-            {
-                terminate(ERROR_SYSCALL_CALLED);
-            }
-            return scheduler_;
+            api::Mutex* res = new Mutex();
+            return proveResource(res);
         }
 
         /**
-         * Creates a new mutex resource.
+         * Creates a new named mutex resource.
          *
+         * @param name - a name of the mutex for profiling.
          * @return a new mutex resource, or NULL if an error has been occurred.
          */
-        api::Mutex* System::createMutex()
+        api::Mutex* System::createMutex(const char* name)
         {
-            api::Mutex* res = new Mutex();
+            api::Mutex* res = new Mutex(name);
+            return proveResource(res);
+        }
+
+        /**
+         * Creates a new named mutex resource, which might inherit priorities.
+         *
+         * @param name         - a name of the mutex for profiling, or NULL.
+         * @param isInheriting - true if the mutex raises the priority of its owner to the priority of a waiter.
+         * @return a new mutex resource, or NULL if an error has been occurred.
+         */
+        api::Mutex* System::createMutex(const char* name, bool isInheriting)
+        {
+            api::Mutex* res = new Mutex(name, isInheriting);
             return proveResource(res);
         }
 
@@ -142,7 +169,21 @@ namespace local
          */
         api::Semaphore* System::createSemaphore(int32 permits, bool isFair)
         {
-            api::Semaphore* res = new Semaphore(permits);
+            api::Semaphore* res = new Semaphore(permits, isFair);
+            return proveResource(res);
+        }
+
+        /**
+         * Creates a new named semaphore resource.
+         *
+         * @param permits - the initial number of permits available.
+         * @param isFair  - true if this semaphore will guarantee FIFO granting of permits under contention.
+         * @param name    - a name of the semaphore for profiling.
+         * @return a new semaphore resource, or NULL if an error has been occurred.
+         */
+        api::Semaphore* System::createSemaphore(int32 permits, bool isFair, const char* name)
+        {
+            api::Semaphore* res = new Semaphore(permits, isFair, name);
             return proveResource(res);
         }
 
@@ -159,6 +200,106 @@ namespace local
             return proveResource(res);
         }
 
+        /**
+         * Creates a new deferred interrupt resource.
+         *
+         * @param handler - user class which implements an interrupt handler interface.
+         * @param source  - available interrupt source number.
+         * @return a new deferred interrupt resource, or NULL if an error has been occurred.
+         */
+        DeferredInterrupt* System::createDeferredInterrupt(api::Task& handler, int32 source)
+        {
+            DeferredInterrupt* res = new DeferredInterrupt(handler, source);
+            return proveResource(res);
+        }
+
+        /**
+         * Creates a new reader-writer lock resource.
+         *
+         * @param isWriterPreferred - true if waiting writers go ahead of new readers.
+         * @return a new reader-writer lock resource, or NULL if an error has been occurred.
+         */
+        ReadWriteLock* System::createReadWriteLock(bool isWriterPreferred)
+        {
+            ReadWriteLock* res = new ReadWriteLock(isWriterPreferred);
+            return proveResource(res);
+        }
+
+        /**
+         * Creates a new message queue resource.
+         *
+         * @param capacity - the maximum number of messages, which is rounded up to a power of two.
+         * @param size     - the size of a message in bytes.
+         * @return a new message queue resource, or NULL if an error has been occurred.
+         */
+        Queue* System::createQueue(int32 capacity, size_t size)
+        {
+            Queue* res = new Queue(capacity, size);
+            return proveResource(res);
+        }
+
+        /**
+         * Creates a new zero-copy message buffer resource.
+         *
+         * @param capacity - the buffer size in bytes, which is rounded up to a power of two.
+         * @return a new message buffer resource, or NULL if an error has been occurred.
+         */
+        MessageBuffer* System::createMessageBuffer(size_t capacity)
+        {
+            MessageBuffer* res = new MessageBuffer(capacity);
+            return proveResource(res);
+        }
+
+        /**
+         * Creates a new event flags resource.
+         *
+         * @return a new event flags resource, or NULL if an error has been occurred.
+         */
+        EventGroup* System::createEventGroup()
+        {
+            EventGroup* res = new EventGroup();
+            return proveResource(res);
+        }
+
+        /**
+         * Creates a new condition variable resource.
+         *
+         * @return a new condition variable resource, or NULL if an error has been occurred.
+         */
+        ConditionVariable* System::createConditionVariable()
+        {
+            ConditionVariable* res = new ConditionVariable();
+            return proveResource(res);
+        }
+
+        /**
+         * Creates a new trace exporter resource.
+         *
+         * @param sink   - a sink of the stream.
+         * @param period - a period of draining in milliseconds.
+         * @return a new trace exporter resource, or NULL if an error has been occurred.
+         */
+        TraceExporter* System::createTraceExporter(TraceSink& sink, int64 period)
+        {
+            TraceExporter* res = new TraceExporter(sink, period);
+            return proveResource(res);
+        }
+
+        /**
+         * Creates a new scheduling latency monitor resource.
+         *
+         * @param period    - a period of wake-ups in milliseconds.
+         * @param priority  - a priority of the monitor thread.
+         * @param threshold - a latency in nanoseconds, exceeding which is notified.
+         * @param listener  - a listener of exceeding latencies, or NULL.
+         * @return a new latency monitor resource, or NULL if an error has been occurred.
+         */
+        LatencyMonitor* System::createLatencyMonitor(int64 period, int32 priority, int64 threshold, LatencyListener* listener)
+        {
+            LatencyMonitor* res = new LatencyMonitor(period, priority, threshold, listener);
+            return proveResource(res);
+        }
+
         /**
          * Terminates the operating system execution.
          *
@@ -195,10 +336,12 @@ namespace local
          */   
         api::System& System::call()
         {
+            #ifndef EOOS_DISABLE_CONSTRUCTION_CHECKS
             if(system_ == NULL)
             {
                 terminate(ERROR_SYSCALL_CALLED);
             }
+            #endif
             return *system_;
         }
         
@@ -231,12 +374,12 @@ namespace local
                     res = false;
                     continue;
                 }
-                if( not heap_.isConstructed() )
+                if( not cpu_.isConstructed() )
                 {
                     res = false;
                     continue;
                 }
-                if( not cpu_.isConstructed() )
+                if( not heap_.isConstructed() )
                 {
                     res = false;
                     continue;
@@ -0,0 +1,97 @@
+/**
+ * Startup timeline of the operating system.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.Timeline.hpp"
+#include "system.Interrupt.hpp"
+#include "system.Clock.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Begins a stage.
+         *
+         * @param name a stage name, which must be a string literal.
+         * @return the stage index, or -1 if the timeline is full.
+         */
+        int32 Timeline::begin(const char* const name)
+        {
+            int64 const time = Clock::getTime();
+            int32 stage = -1;
+            bool const is = Interrupt::disableAll();
+            if(length_ < STAGES)
+            {
+                stage = length_++;
+                stages_[stage].name = name;
+                stages_[stage].begin = time;
+                stages_[stage].duration = -1;
+            }
+            Interrupt::enableAll(is);
+            return stage;
+        }
+
+        /**
+         * Ends a stage.
+         *
+         * @param stage the stage index.
+         */
+        void Timeline::end(int32 const stage)
+        {
+            int64 const time = Clock::getTime();
+            if(stage < 0 || stage >= STAGES) return;
+            bool const is = Interrupt::disableAll();
+            stages_[stage].duration = time - stages_[stage].begin;
+            Interrupt::enableAll(is);
+        }
+
+        /**
+         * Ends a stage, and begins a next one.
+         *
+         * @param stage the stage index.
+         * @param name  a next stage name, which must be a string literal.
+         * @return the next stage index, or -1 if the timeline is full.
+         */
+        int32 Timeline::next(int32 const stage, const char* const name)
+        {
+            end(stage);
+            return begin(name);
+        }
+
+        /**
+         * Copies the stages.
+         *
+         * @param stages a buffer for stages.
+         * @param count  the maximum number of stages to copy.
+         * @return the number of stages copied.
+         */
+        int32 Timeline::read(Stage* const stages, int32 const count)
+        {
+            bool const is = Interrupt::disableAll();
+            int32 const length = length_ < count ? length_ : count;
+            for(int32 i=0; i<length; i++)
+            {
+                stages[i] = stages_[i];
+            }
+            Interrupt::enableAll(is);
+            return length > 0 ? length : 0;
+        }
+
+        /**
+         * The stages.
+         *
+         * NOTE: The variables are not initialized by constructors, so stages
+         * can be recorded by static objects before all constructors are called.
+         */
+        Timeline::Stage Timeline::stages_[Timeline::STAGES];
+
+        /**
+         * The number of stages.
+         */
+        int32 Timeline::length_ = 0;
+    }
+}
@@ -0,0 +1,184 @@
+/**
+ * Kernel event tracer.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.Trace.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * Makes a reader the only reader of the records.
+         *
+         * @param reader a reader.
+         * @return true if the reader has been attached, or false if another one is attached.
+         */
+        bool Trace::attach(const void* const reader)
+        {
+            if(reader == NULL) return false;
+            return reader_.compareAndSwap(NULL, reader);
+        }
+
+        /**
+         * Lets another reader be attached.
+         *
+         * @param reader the attached reader.
+         */
+        void Trace::detach(const void* const reader)
+        {
+            static_cast<void>( reader_.compareAndSwap(reader, NULL) );
+        }
+
+        /**
+         * Reads records of a core, which have not been read yet.
+         *
+         * @param reader  the attached reader.
+         * @param core    a core number.
+         * @param records an array for the records.
+         * @param count   the array length.
+         * @return the number of read records.
+         */
+        int32 Trace::read(const void* const reader, int32 const core, Record* const records, int32 const count)
+        {
+            int32 number = 0;
+            // Another reader would move the read positions of the attached one
+            if(reader == NULL || reader_.load() != reader) return 0;
+            #ifdef EOOS_ENABLE_TRACE
+            if(core < 0 || core >= CORES || records == NULL) return 0;
+            Ring& ring = rings_[core];
+            while(number < count)
+            {
+                uint32 const head = ring.head.load();
+                // Skip the records overwritten by writers
+                if(head - ring.tail > LENGTH)
+                {
+                    ring.lost += head - ring.tail - LENGTH;
+                    ring.tail = head - LENGTH;
+                }
+                if(ring.tail == head) break;
+                Slot& slot = ring.slots[ring.tail & (LENGTH - 1)];
+                uint16 const sequence = static_cast<uint16>(ring.tail + 1);
+                // A writer which has reserved the record has not written it yet
+                if(slot.sequence.load() != sequence)
+                {
+                    if(ring.head.load() - ring.tail > LENGTH) continue;
+                    break;
+                }
+                Record& record = records[number];
+                record.time = slot.time;
+                record.object = slot.object;
+                record.event = slot.event;
+                record.core = static_cast<uint16>(core);
+                // The record might have been overwritten while it has been copied
+                if(slot.sequence.load() != sequence) continue;
+                ring.tail++;
+                number++;
+            }
+            #else
+            static_cast<void>(core);
+            static_cast<void>(records);
+            static_cast<void>(count);
+            #endif
+            return number;
+        }
+
+        /**
+         * Returns the number of records of a core, which have been overwritten before reading.
+         *
+         * @param core a core number.
+         * @return the number of lost records.
+         */
+        int64 Trace::getLost(int32 const core)
+        {
+            #ifdef EOOS_ENABLE_TRACE
+            if(core < 0 || core >= CORES) return 0;
+            return rings_[core].lost;
+            #else
+            static_cast<void>(core);
+            return 0;
+            #endif
+        }
+
+        /**
+         * The attached reader, or NULL if the records have no reader.
+         */
+        Atomic<const void*> Trace::reader_(NULL);
+
+        #ifdef EOOS_ENABLE_TRACE
+
+        /**
+         * The ring buffers of the cores.
+         */
+        Trace::Ring Trace::rings_[Trace::CORES];
+
+        #endif // EOOS_ENABLE_TRACE
+    }
+}
+
+#ifdef EOOS_ENABLE_TRACE
+
+/**
+ * Records a switch to a kernel task.
+ *
+ * @param task the task control block.
+ */
+void eoosTraceTaskSwitchedIn(void* const task)
+{
+    local::system::Trace::record(local::system::Trace::THREAD_SWITCH_IN, task);
+}
+
+/**
+ * Records a switch from a kernel task.
+ *
+ * @param task the task control block.
+ */
+void eoosTraceTaskSwitchedOut(void* const task)
+{
+    local::system::Trace::record(local::system::Trace::THREAD_SWITCH_OUT, task);
+}
+
+/**
+ * Records a creation of a kernel task.
+ *
+ * @param task the task control block.
+ */
+void eoosTraceTaskCreate(void* const task)
+{
+    local::system::Trace::record(local::system::Trace::THREAD_CREATE, task);
+}
+
+/**
+ * Records a deletion of a kernel task.
+ *
+ * @param task the task control block.
+ */
+void eoosTraceTaskDelete(void* const task)
+{
+    local::system::Trace::record(local::system::Trace::THREAD_DELETE, task);
+}
+
+/**
+ * Records blocking of a task on receiving from a kernel queue or semaphore.
+ *
+ * @param queue the kernel queue.
+ */
+void eoosTraceBlockingOnQueueReceive(void* const queue)
+{
+    local::system::Trace::record(local::system::Trace::QUEUE_RECEIVE_BLOCK, queue);
+}
+
+/**
+ * Records blocking of a task on sending to a kernel queue or semaphore.
+ *
+ * @param queue the kernel queue.
+ */
+void eoosTraceBlockingOnQueueSend(void* const queue)
+{
+    local::system::Trace::record(local::system::Trace::QUEUE_SEND_BLOCK, queue);
+}
+
+#endif // EOOS_ENABLE_TRACE
@@ -0,0 +1,252 @@
+/**
+ * Trace exporter class.
+ *
+ * @author    Sergey Baigudin, sergey@baigudin.software
+ * @copyright 2018, Embedded Team, Sergey Baigudin
+ * @license   http://embedded.team/license/
+ */
+#include "system.TraceExporter.hpp"
+#include "system.Timeout.hpp"
+
+namespace local
+{
+    namespace system
+    {
+        /**
+         * The metadata of the stream in the Trace Stream Description Language.
+         *
+         * The event identifiers are the trace events, and the integers are byte
+         * aligned, so the packets have no padding.
+         */
+        static const char METADATA[] =
+            "/* CTF 1.8 */\n"
+            "typealias integer { size = 16; align = 8; signed = false; } := uint16_t;\n"
+            "typealias integer { size = 32; align = 8; signed = false; } := uint32_t;\n"
+            "typealias integer { size = 64; align = 8; signed = false; } := uint64_t;\n"
+            "typealias integer { size = 64; align = 8; signed = false; map = clock.monotonic.value; } := uint64_clock_t;\n"
+            "trace {\n"
+            "    major = 1;\n"
+            "    minor = 8;\n"
+            "    byte_order = le;\n"
+            "    packet.header := struct {\n"
+            "        uint32_t magic;\n"
+            "        uint32_t stream_id;\n"
+            "    };\n"
+            "};\n"
+            "clock {\n"
+            "    name = monotonic;\n"
+            "    freq = 1000000000;\n"
+            "};\n"
+            "stream {\n"
+            "    id = 0;\n"
+            "    packet.context := struct {\n"
+            "        uint64_clock_t timestamp_begin;\n"
+            "        uint64_clock_t timestamp_end;\n"
+            "        uint64_t content_size;\n"
+            "        uint64_t packet_size;\n"
+            "        uint32_t cpu_id;\n"
+            "    };\n"
+            "    event.header := struct {\n"
+            "        uint16_t id;\n"
+            "        uint64_clock_t timestamp;\n"
+            "    };\n"
+            "};\n"
+            "event { name = \"thread_switch_in\"; id = 1; stream_id = 0; fields := struct { uint64_t tid; }; };\n"
+            "event { name = \"thread_switch_out\"; id = 2; stream_id = 0; fields := struct { uint64_t tid; }; };\n"
+            "event { name = \"thread_create\"; id = 3; stream_id = 0; fields := struct { uint64_t tid; }; };\n"
+            "event { name = \"thread_delete\"; id = 4; stream_id = 0; fields := struct { uint64_t tid; }; };\n"
+            "event { name = \"thread_start\"; id = 5; stream_id = 0; fields := struct { uint64_t thread; }; };\n"
+            "event { name = \"queue_receive_block\"; id = 6; stream_id = 0; fields := struct { uint64_t queue; }; };\n"
+            "event { name = \"queue_send_block\"; id = 7; stream_id = 0; fields := struct { uint64_t queue; }; };\n"
+            "event { name = \"interrupt_enter\"; id = 8; stream_id = 0; fields := struct { uint64_t source; }; };\n"
+            "event { name = \"interrupt_exit\"; id = 9; stream_id = 0; fields := struct { uint64_t source; }; };\n"
+            "event { name = \"mutex_wait\"; id = 10; stream_id = 0; fields := struct { uint64_t mutex; }; };\n"
+            "event { name = \"mutex_lock\"; id = 11; stream_id = 0; fields := struct { uint64_t mutex; }; };\n"
+            "event { name = \"mutex_unlock\"; id = 12; stream_id = 0; fields := struct { uint64_t mutex; }; };\n"
+            "event { name = \"semaphore_wait\"; id = 13; stream_id = 0; fields := struct { uint64_t semaphore; }; };\n"
+            "event { name = \"semaphore_acquire\"; id = 14; stream_id = 0; fields := struct { uint64_t semaphore; }; };\n"
+            "event { name = \"semaphore_release\"; id = 15; stream_id = 0; fields := struct { uint64_t semaphore; }; };\n"
+            "event { name = \"thread_object_create\"; id = 16; stream_id = 0; fields := struct { uint64_t thread; }; };\n";
+
+        /**
+         * The magic number of a packet.
+         */
+        static const uint32 MAGIC = 0xC1FC1FC1;
+
+        /**
+         * Constructor.
+         *
+         * @param sink   a sink of the stream.
+         * @param period a period of draining in milliseconds.
+         */
+        TraceExporter::TraceExporter(TraceSink& sink, int64 const period) : Parent(),
+            sink_       (sink),
+            period_     (Timeout::toTicks(period)),
+            task_       (NULL),
+            isAttached_ (false),
+            isStopping_ (false),
+            isStopped_  (false),
+            isFailed_   (false){
+            bool const isConstructed = construct();
+            setConstructed( isConstructed );
+        }
+
+        /**
+         * Destructor.
+         */
+        TraceExporter::~TraceExporter()
+        {
+            if(task_ != NULL)
+            {
+                isStopping_.store(true);
+                // The thread drains the rest of records, and deletes itself
+                while( not isStopped_.load() )
+                {
+                    vTaskDelay(1);
+                }
+            }
+            if(isAttached_)
+            {
+                Trace::detach(this);
+            }
+        }
+
+        /**
+         * Tests if this object has been constructed.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool TraceExporter::isConstructed() const
+        {
+            return Parent::isConstructed();
+        }
+
+        /**
+         * Tests if this resource is blocked.
+         *
+         * @return true if the sink has failed.
+         */
+        bool TraceExporter::isBlocked() const
+        {
+            if( not Self::isConstructed() ) return false;
+            return isFailed_.load();
+        }
+
+        /**
+         * Writes the metadata of the stream.
+         *
+         * @param sink a sink of the metadata.
+         * @return true if the metadata has been written.
+         */
+        bool TraceExporter::writeMetadata(TraceSink& sink)
+        {
+            return sink.write(METADATA, sizeof(METADATA) - 1);
+        }
+
+        /**
+         * Constructor.
+         *
+         * @return true if object has been constructed successfully.
+         */
+        bool TraceExporter::construct()
+        {
+            if( not Self::isConstructed() ) return false;
+            if(period_ == 0)
+            {
+                period_ = 1;
+            }
+            isAttached_ = Trace::attach(this);
+            if( not isAttached_ ) return false;
+            return xTaskCreate(&main, "TRACE", STACK_SIZE, this, tskIDLE_PRIORITY + 1, &task_) == pdPASS;
+        }
+
+        /**
+         * Drains the trace buffers to the sink.
+         *
+         * @return true if the sink has written all the packets.
+         */
+        bool TraceExporter::drain()
+        {
+            for(int32 core=0; core<Trace::CORES; core++)
+            {
+                while(true)
+                {
+                    int32 const count = Trace::read(this, core, records_, RECORDS);
+                    if(count == 0) break;
+                    if( not send(core, count) ) return false;
+                    if(count < RECORDS) break;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Writes a packet of records of a core to the sink.
+         *
+         * @param core  a core number.
+         * @param count the number of records.
+         * @return true if the sink has written the packet.
+         */
+        bool TraceExporter::send(int32 const core, int32 const count)
+        {
+            uint64 const size = static_cast<uint64>(HEADER_SIZE + count * EVENT_SIZE) * 8;
+            uint8* buf = packet_;
+            buf = put(buf, MAGIC, 4);
+            buf = put(buf, 0, 4);
+            buf = put(buf, static_cast<uint64>(records_[0].time), 8);
+            buf = put(buf, static_cast<uint64>(records_[count - 1].time), 8);
+            buf = put(buf, size, 8);
+            buf = put(buf, size, 8);
+            buf = put(buf, static_cast<uint64>(core), 4);
+            for(int32 i=0; i<count; i++)
+            {
+                buf = put(buf, records_[i].event, 2);
+                buf = put(buf, static_cast<uint64>(records_[i].time), 8);
+                buf = put(buf, records_[i].object, 8);
+            }
+            return sink_.write(packet_, static_cast<size_t>(buf - packet_));
+        }
+
+        /**
+         * Drains the trace buffers periodically.
+         *
+         * @param argument the exporter.
+         */
+        void TraceExporter::main(void* const argument)
+        {
+            TraceExporter& exporter = *static_cast<TraceExporter*>(argument);
+            while( not exporter.isStopping_.load() )
+            {
+                vTaskDelay(exporter.period_);
+                if( not exporter.isFailed_.load() && not exporter.drain() )
+                {
+                    exporter.isFailed_.store(true);
+                }
+            }
+            if( not exporter.isFailed_.load() )
+            {
+                static_cast<void>( exporter.drain() );
+            }
+            exporter.isStopped_.store(true);
+            vTaskDelete(NULL);
+        }
+
+        /**
+         * Puts an integer to a buffer in the little-endian byte order.
+         *
+         * @param buf   a buffer.
+         * @param value a value.
+         * @param size  the value size in bytes.
+         * @return the buffer address next to the value.
+         */
+        uint8* TraceExporter::put(uint8* buf, uint64 value, int32 const size)
+        {
+            for(int32 i=0; i<size; i++)
+            {
+                *buf++ = static_cast<uint8>(value);
+                value >>= 8;
+            }
+            return buf;
+        }
+    }
+}